@@ -3,886 +3,2882 @@
 #pragma once
 #include <iostream>  // for std::cout
 #include <vector>    // for std::vector
-#include <algorithm> // for std::find and std::remove
+#include <algorithm> // for std::find, std::remove and std::count
 #include <stdexcept> // for std::invalid_argument
 #include <sstream>   // for std::ostringstream
+#include <memory>    // for std::shared_ptr
+#include <functional> // for std::less and std::greater
+#include <utility>   // for std::pair
+#include <initializer_list> // for std::initializer_list
+#include <cstring>   // for std::memcpy
+#include <type_traits> // for std::is_trivially_copyable
+#include <cassert>   // for assert
+#include <future>    // for std::future, std::promise
+#include "MyContainerStats.hpp"
+#include "MyContainerTrace.hpp"
+#include "MyContainerHistogram.hpp"
+#include "MyContainerFormat.hpp"
+#include "MyContainerIO.hpp"
+#include "MyContainerIngest.hpp"
+#include "MyContainerExternalSort.hpp"
+#include "MyContainerBackground.hpp"
 
 using namespace std;
 
+/**
+ * @brief Bounds checking policy of the iterators' operator*.
+ * 2 (default) - throw std::out_of_range when dereferencing past the end.
+ * 1           - assert only (compiled out together with asserts under NDEBUG).
+ * 0           - unchecked, for release builds whose traversal loops must stay branch free.
+ */
+#ifndef MYCONTAINER_ITERATOR_CHECKS
+#define MYCONTAINER_ITERATOR_CHECKS 2
+#endif
+
+// Instruments an iterator constructor: counts it, times the snapshot build and traces it until the end of the scope
+#define MYCONTAINER_SNAPSHOT_SCOPE(container, kind)                                                                               \
+    MYCONTAINER_STAT(detail::SnapshotScope snapshot_scope((container).statistics, (kind)));                                       \
+    MYCONTAINER_TRACE_SCOPE(ContainerStats::iteratorName(kind), (container).elements.size());                                     \
+    MYCONTAINER_LATENCY_SCOPE(detail::iteratorLatencyOp(kind))
+
 namespace my_cont_ns
 {
+    /**
+     * @brief A read-only contiguous run of elements (pointer + length).
+     * Handed out by the forEachSpan() methods of the iterator classes so that consumers
+     * can process plain arrays instead of dereferencing one element at a time.
+     */
+    template <typename T>
+    struct Span
+    {
+        const T *data; // First element of the run
+        size_t size;   // Number of elements in the run
+    };
+
+    /**
+     * @brief Names the six traversal orders of MyContainer.
+     * Used by the APIs that select an order at run time, like MyContainer::materialize().
+     */
+    enum class OrderKind
+    {
+        AscendingOrder,
+        DescendingOrder,
+        SideCrossOrder,
+        ReverseOrder,
+        Order,
+        MiddleOutOrder
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Copies a run of trivially copyable elements with a single memcpy.
+         * @param src First element to copy.
+         * @param count Number of elements to copy.
+         * @param out Destination with room for count elements.
+         * @returns void
+         * @throw None
+         */
+        template <typename T>
+        void copyRun(const T *src, size_t count, T *out, std::true_type)
+        {
+            if (count != 0)
+            {
+                std::memcpy(out, src, count * sizeof(T));
+            }
+        }
+
+        /**
+         * @brief Copies a run of elements by assignment (types that are not trivially copyable).
+         * @param src First element to copy.
+         * @param count Number of elements to copy.
+         * @param out Destination with count constructed elements.
+         * @returns void
+         * @throw Whatever T's copy assignment throws.
+         */
+        template <typename T>
+        void copyRun(const T *src, size_t count, T *out, std::false_type)
+        {
+            std::copy(src, src + count, out);
+        }
+
+        /**
+         * @brief Copies a run of elements, using memcpy whenever T allows it.
+         * @param src First element to copy.
+         * @param count Number of elements to copy.
+         * @param out Destination with room for count elements.
+         * @returns void
+         * @throw Whatever T's copy assignment throws.
+         */
+        template <typename T>
+        void copyRun(const T *src, size_t count, T *out)
+        {
+            copyRun(src, count, out, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+        }
+
+        /**
+         * @brief Validates an iterator position according to MYCONTAINER_ITERATOR_CHECKS.
+         * @param index The position being dereferenced.
+         * @param size Number of elements in the traversal.
+         * @returns void
+         * @throw std::out_of_range if checks are enabled and index is not smaller than size.
+         */
+        inline void checkIteratorIndex(size_t index, size_t size)
+        {
+#if MYCONTAINER_ITERATOR_CHECKS >= 2
+            if (index >= size)
+            {
+                throw std::out_of_range("Iterator out of range");
+            }
+#elif MYCONTAINER_ITERATOR_CHECKS == 1
+            assert(index < size && "Iterator out of range");
+            (void)index;
+            (void)size;
+#else
+            (void)index;
+            (void)size;
+#endif
+        }
+
+        /**
+         * @brief Maps a position of the middle-out order to an index in insertion order.
+         *
+         * @note The left side runs out first (the middle is the left middle), after that only the right side is left.
+         *
+         * @param position Position in the middle-out order, smaller than size.
+         * @param size Number of elements.
+         * @returns Index of the element in insertion order.
+         * @throw None
+         */
+        inline size_t middleOutIndex(size_t position, size_t size)
+        {
+            size_t middle = (size - 1) / 2;
+            if (position == 0)
+            {
+                return middle;
+            }
+            if (position > 2 * middle)
+            {
+                return middle + (position - middle); // Only the right side is left
+            }
+            return (position % 2 == 1) ? middle - (position + 1) / 2 : middle + position / 2;
+        }
+
+        /**
+         * @brief Maps a position of the side-cross order to an index in ascending order.
+         * @param position Position in the side-cross order, smaller than size.
+         * @param size Number of elements.
+         * @returns Index of the element in the ascending order.
+         * @throw None
+         */
+        inline size_t sideCrossIndex(size_t position, size_t size)
+        {
+            return (position % 2 == 0) ? position / 2 : size - 1 - position / 2;
+        }
+
+        /**
+         * @brief Computes the permutation that sorts values ascending, for trivially copyable types.
+         * Sorts (value, index) pairs, which stays in contiguous memory unlike an indirect index sort.
+         * @param values The first value.
+         * @param count Number of values.
+         * @param permutation Receives permutation[i] = index of the i-th smallest value.
+         * @returns void
+         * @throw None
+         */
+        template <typename T>
+        void ascendingPermutation(const T *values, size_t count, std::vector<size_t> &permutation, std::true_type)
+        {
+            std::vector<std::pair<T, size_t>> keyed(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                keyed[i] = std::pair<T, size_t>(values[i], i);
+            }
+            std::sort(keyed.begin(), keyed.end(),
+                      [](const std::pair<T, size_t> &a, const std::pair<T, size_t> &b) { return a.first < b.first; });
+            permutation.resize(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                permutation[i] = keyed[i].second;
+            }
+        }
+
+        /**
+         * @brief Computes the permutation that sorts values ascending by sorting indices (no element copies).
+         * @param values The first value.
+         * @param count Number of values.
+         * @param permutation Receives permutation[i] = index of the i-th smallest value.
+         * @returns void
+         * @throw Whatever T's operator< throws.
+         */
+        template <typename T>
+        void ascendingPermutation(const T *values, size_t count, std::vector<size_t> &permutation, std::false_type)
+        {
+            permutation.resize(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                permutation[i] = i;
+            }
+            std::sort(permutation.begin(), permutation.end(), [values](size_t a, size_t b) { return values[a] < values[b]; });
+        }
+
+        /**
+         * @brief Computes the permutation that sorts values ascending.
+         * @param values The first value.
+         * @param count Number of values.
+         * @param permutation Receives permutation[i] = index of the i-th smallest value.
+         * @returns void
+         * @throw Whatever T's operator< throws.
+         */
+        template <typename T>
+        void ascendingPermutation(const T *values, size_t count, std::vector<size_t> &permutation)
+        {
+            ascendingPermutation(values, count, permutation, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+        }
+
+        /**
+         * @brief Calls fn once per chunk of a contiguous array.
+         * @param data The first element of the array.
+         * @param count Number of elements in the array.
+         * @param chunk_size Maximum number of elements per span.
+         * @param fn Callable invoked with a Span<T> per chunk.
+         * @returns void
+         * @throw std::invalid_argument if chunk_size is 0.
+         */
+        template <typename T, typename Function>
+        void forEachSpanOf(const T *data, size_t count, size_t chunk_size, Function &fn)
+        {
+            if (chunk_size == 0)
+            {
+                throw std::invalid_argument("Span size must be positive");
+            }
+            for (size_t start = 0; start < count; start += chunk_size)
+            {
+                Span<T> span = {data + start, std::min(chunk_size, count - start)};
+                fn(span);
+            }
+        }
+
+        /**
+         * @brief Calls fn once per chunk of an order that is an index mapping of a contiguous array.
+         * The chunk is gathered into a reused buffer, so the span is only valid during the call.
+         * @param count Number of elements in the order.
+         * @param chunk_size Maximum number of elements per span.
+         * @param fn Callable invoked with a Span<T> per chunk.
+         * @param at Callable returning the element at a position of the order.
+         * @returns void
+         * @throw std::invalid_argument if chunk_size is 0.
+         */
+        template <typename T, typename Function, typename Accessor>
+        void forEachGatheredSpan(size_t count, size_t chunk_size, Function &fn, Accessor at)
+        {
+            if (chunk_size == 0)
+            {
+                throw std::invalid_argument("Span size must be positive");
+            }
+            std::vector<T> buffer;
+            buffer.reserve(std::min(chunk_size, count));
+            for (size_t start = 0; start < count; start += chunk_size)
+            {
+                size_t length = std::min(chunk_size, count - start);
+                buffer.clear();
+                for (size_t i = 0; i < length; ++i)
+                {
+                    buffer.push_back(at(start + i));
+                }
+                Span<T> span = {buffer.data(), length};
+                fn(span);
+            }
+        }
+
+        /**
+         * @brief A shared_ptr that is read and replaced atomically.
+         * Lets const readers publish a lazily built cache while other readers use the previous one.
+         * Copies take an atomic snapshot of the pointer.
+         */
+        template <typename Value>
+        class SharedSlot
+        {
+        private:
+            std::shared_ptr<Value> value;
+
+        public:
+            SharedSlot() {}
+
+            SharedSlot(const SharedSlot &other) : value(other.load()) {}
+
+            SharedSlot &operator=(const SharedSlot &other)
+            {
+                store(other.load());
+                return *this;
+            }
+
+            // Moves leave the source empty, so a moved-from container does not keep serving its old cache
+            SharedSlot(SharedSlot &&other) : value(std::atomic_exchange(&other.value, std::shared_ptr<Value>())) {}
+
+            SharedSlot &operator=(SharedSlot &&other)
+            {
+                if (this != &other)
+                {
+                    store(std::atomic_exchange(&other.value, std::shared_ptr<Value>()));
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Returns the current value.
+             * @param None
+             * @returns The stored pointer (may be null).
+             * @throw None
+             */
+            std::shared_ptr<Value> load() const { return std::atomic_load(&value); }
+
+            /**
+             * @brief Replaces the current value.
+             * @param replacement The new pointer (may be null).
+             * @returns void
+             * @throw None
+             */
+            void store(std::shared_ptr<Value> replacement) { std::atomic_store(&value, std::move(replacement)); }
+        };
+
+        /**
+         * @brief Finds the runs of equal values in an ascending sequence.
+         * @param sorted The ascending sequence.
+         * @returns The position of the first element of every run.
+         * @throw None
+         */
+        template <typename T>
+        std::vector<size_t> runStarts(const std::vector<T> &sorted)
+        {
+            std::vector<size_t> starts;
+            for (size_t i = 0; i < sorted.size(); ++i)
+            {
+                if (i == 0 || !(sorted[i] == sorted[i - 1]))
+                {
+                    starts.push_back(i);
+                }
+            }
+            return starts;
+        }
+    }
+
+    /**
+     * @brief ExternalSortedOrder Iterator Class
+     * Traverses elements in sorted order (Compare) through an external-memory sort: runs that fit the memory
+     * budget are sorted and spilled to temporary files, and the order is streamed out of a k-way merge, so the
+     * sorted copy never has to fit in memory.
+     *
+     * @note Single pass: every copy of the iterator shares one read position, so the order can be traversed
+     * once and begin() returns the current position. Requires a trivially copyable T.
+     */
+    template <typename T, typename Compare>
+    class ExternalSortedOrder
+    {
+    private:
+        std::shared_ptr<detail::ExternalMerge<T, Compare>> merge; // Shared with every copy of this iterator
+        size_t current_index;
+
+    public:
+        /**
+         * @brief Constructor for the ExternalSortedOrder iterator.
+         * Sorts and spills the runs; the final merge then runs as the iterator advances.
+         * @param data The elements to order, read run by run.
+         * @param count Number of elements.
+         * @param memory_budget Bytes available for element buffers (run buffer and merge read buffers).
+         * @param temp_directory Directory for the spill files; empty to use $TMPDIR, or /tmp if it is not set.
+         * @returns ExternalSortedOrder object.
+         * @throw std::invalid_argument if the budget cannot hold 3 elements.
+         * @throw std::runtime_error if a spill file cannot be created, written or read.
+         */
+        ExternalSortedOrder(const T *data, size_t count, size_t memory_budget, const std::string &temp_directory)
+            : current_index(0)
+        {
+            MYCONTAINER_TRACE_SCOPE("external sort", count);
+            merge = std::make_shared<detail::ExternalMerge<T, Compare>>(data, count, memory_budget, temp_directory);
+        }
+
+        /**
+         * @brief Pre-increment operator for the ExternalSortedOrder iterator.
+         * @param None
+         * @returns Reference to the current ExternalSortedOrder object after incrementing.
+         * @throw std::runtime_error if a spill file cannot be read.
+         */
+        ExternalSortedOrder &operator++()
+        {
+            if (!merge->done())
+            {
+                merge->advance();
+            }
+            ++current_index;
+            return *this;
+        }
+
+        /**
+         * @brief Post-increment operator for the ExternalSortedOrder iterator.
+         *
+         * @note The returned copy shares the read position, dereferencing it yields the new current element.
+         *
+         * @param None
+         * @returns A copy of the ExternalSortedOrder object before incrementing.
+         * @throw std::runtime_error if a spill file cannot be read.
+         */
+        ExternalSortedOrder operator++(int)
+        {
+            ExternalSortedOrder temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        /**
+         * @brief Dereference operator for the ExternalSortedOrder iterator.
+         * @param None
+         * @returns A constant reference to the current element, valid until the iterator advances.
+         * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+         */
+        const T &operator*() const
+        {
+            detail::checkIteratorIndex(merge->position(), merge->size()); // The shared position, not this copy's
+            return merge->current();
+        }
+
+        /**
+         * @brief Equality operator for the ExternalSortedOrder iterator.
+         * @param other Another ExternalSortedOrder iterator to compare with.
+         * @returns true if both iterators point to the same index, false otherwise.
+         * @throw None
+         */
+        bool operator==(const ExternalSortedOrder &other) const
+        {
+            return current_index == other.current_index;
+        }
+
+        /**
+         * @brief Inequality operator for the ExternalSortedOrder iterator.
+         * @param other Another ExternalSortedOrder iterator to compare with.
+         * @returns true if the iterators point to different indices, false otherwise.
+         * @throw None
+         */
+        bool operator!=(const ExternalSortedOrder &other) const
+        {
+            return !(*this == other);
+        }
+
+        /**
+         * @brief Begin method for the ExternalSortedOrder iterator.
+         * @param None
+         * @returns A copy of this iterator (the order is single pass and cannot be rewound).
+         * @throw None
+         */
+        ExternalSortedOrder begin()
+        {
+            return *this;
+        }
+
+        /**
+         * @brief End method for the ExternalSortedOrder iterator.
+         * @param None
+         * @returns A new ExternalSortedOrder iterator pointing to one past the last element.
+         * @throw None
+         */
+        ExternalSortedOrder end()
+        {
+            ExternalSortedOrder iter = *this;
+            iter.current_index = merge->size();
+            return iter;
+        }
+
+        /**
+         * @brief Returns the number of sorted runs that were spilled to temporary files.
+         * @param None
+         * @returns 0 if the elements fit the memory budget.
+         * @throw None
+         */
+        size_t spilledRuns() const { return merge->spilledRuns(); }
+
+        /**
+         * @brief Returns the number of merge passes, including the final streaming merge.
+         * @param None
+         * @returns 0 if the elements fit the memory budget.
+         * @throw None
+         */
+        size_t mergePasses() const { return merge->mergePasses(); }
+
+        /**
+         * @brief Returns the largest amount of element buffer memory held at once.
+         * @param None
+         * @returns Bytes, never more than the memory budget.
+         * @throw None
+         */
+        size_t peakBufferBytes() const { return merge->peakBufferBytes(); }
+    };
+
+    template <typename T, typename Compare>
+    class MergedOrder;
+
+    template <typename T, typename Hash>
+    class ShardedMyContainer;
+
     template <typename T = int> // Declares MyContainer as a template class with a default type of int
     class MyContainer
     {
     private:
-        std::vector<T> elements; // Vector to store elements of type T
+        detail::BackgroundSort background; // Opt-in sort cache rebuilds after mutations; first, so it stops before the elements change
+        std::vector<T> elements;           // Vector to store elements of type T
+#ifdef MYCONTAINER_STATS
+        mutable ContainerStats statistics; // Instrumentation counters (see MYCONTAINER_STATS)
+#endif
+        mutable detail::SharedSlot<const std::vector<T>> sort_cache;     // Elements in ascending order, null when stale
+        mutable detail::SharedSlot<const std::vector<size_t>> run_cache; // Run starts of sort_cache, null when stale
+
+        template <typename U, typename Compare>
+        friend class MergedOrder; // Merges the sort caches of several containers
+        template <typename U, typename Hash>
+        friend class ShardedMyContainer; // Warms the shards' sort caches and rolls back failed bulk adds
 
-    public:
         /**
-         * @brief Default constructor for MyContainer.
-         * Initializes an empty container.
+         * @brief Returns the elements in ascending order, sorting them only if the cache is stale.
+         * Every sorted traversal reads this one immutable vector, so iterators share it instead of copying.
+         * Large containers are sorted with a parallel merge sort on ThreadPool::instance().
          * @param None
-         * @returns MyContainer object.
+         * @returns The ascending elements, shared with the cache.
          * @throw None
          */
-        MyContainer()
+        std::shared_ptr<const std::vector<T>> sortedElements() const
         {
-            // Empty - std::vector automatically initializes as empty
-            // note: doing: elements = std::vector<T>(); here is exactly the same as not doing anything
+            std::shared_ptr<const std::vector<T>> cached = sort_cache.load();
+            if (cached)
+            {
+                MYCONTAINER_STAT(statistics.sort_cache_hits.fetch_add(1, std::memory_order_relaxed));
+                return cached;
+            }
+            std::shared_ptr<std::vector<T>> sorted = std::make_shared<std::vector<T>>(elements);
+            MYCONTAINER_STAT(statistics.recordCopy(elements.size(), sizeof(T)));
+            sortAscending(*sorted);
+            sort_cache.store(sorted);
+            return sorted;
+        }
+
+        /**
+         * @brief Sorts a copy of the elements for the sort cache.
+         * Large copies are sorted with a parallel merge sort on ThreadPool::instance().
+         * @param sorted The copy to sort in place.
+         * @returns void
+         * @throw None
+         */
+        void sortAscending(std::vector<T> &sorted) const
+        {
+            {
+                MYCONTAINER_TRACE_SCOPE("sort", sorted.size());
+                if (sorted.size() > detail::PARALLEL_SORT_GRAIN)
+                {
+                    detail::parallelSort(ThreadPool::instance(), sorted.begin(), sorted.end(), std::less<T>());
+                }
+                else
+                {
+                    std::sort(sorted.begin(), sorted.end());
+                }
+            }
+            MYCONTAINER_STAT(statistics.sorts.fetch_add(1, std::memory_order_relaxed));
         }
 
         /**
-         * @brief Returns the number of elements in the container.
-         * @param None
-         * @returns The size of the container.
-         * @throw None
+         * @brief Background sort job: rebuilds the sort cache on the worker thread of enableBackgroundSort().
+         * The elements are copied under the mutation lock and sorted without it; the result is dropped if a
+         * mutation happened in the meantime or a reader already built the cache.
+         * @param held The worker's lock, held on entry and on return.
+         * @returns void
+         * @throw None
+         */
+        void rebuildSortCache(std::unique_lock<std::mutex> &held) const
+        {
+            if (sort_cache.load())
+            {
+                return; // A reader sorted first
+            }
+            const uint64_t generation = background.generation();
+            std::shared_ptr<std::vector<T>> sorted = std::make_shared<std::vector<T>>(elements);
+            MYCONTAINER_STAT(statistics.recordCopy(elements.size(), sizeof(T)));
+            held.unlock();
+            sortAscending(*sorted);
+            held.lock();
+            if (background.generation() == generation && !sort_cache.load())
+            {
+                MYCONTAINER_STAT(statistics.background_sorts.fetch_add(1, std::memory_order_relaxed));
+                sort_cache.store(sorted);
+            }
+        }
+
+        /**
+         * @brief Returns the start of every run of equal values in the sort cache, computing them only once.
+         * @param sorted The current sort cache (see sortedElements()).
+         * @returns The run starts, shared with the cache.
+         * @throw None
+         */
+        std::shared_ptr<const std::vector<size_t>> sortedRunStarts(const std::vector<T> &sorted) const
+        {
+            std::shared_ptr<const std::vector<size_t>> cached = run_cache.load();
+            if (cached)
+            {
+                return cached;
+            }
+            std::shared_ptr<const std::vector<size_t>> starts = std::make_shared<const std::vector<size_t>>(detail::runStarts(sorted));
+            run_cache.store(starts);
+            return starts;
+        }
+
+        /**
+         * @brief Runs an iterator factory on ThreadPool::instance() and hands out its result through a future.
+         * @param factory Callable invoked as factory() on a pool thread, returning the iterator.
+         * @returns A future that becomes ready once the iterator is built.
+         * @throw std::bad_alloc if the task cannot be queued.
+         */
+        template <typename Iterator, typename Factory>
+        std::future<Iterator> buildAsync(Factory factory) const
+        {
+            // std::function needs a copyable task, so the promise is shared
+            std::shared_ptr<std::promise<Iterator>> promise = std::make_shared<std::promise<Iterator>>();
+            std::future<Iterator> result = promise->get_future();
+            ThreadPool::instance().submit([promise, factory]()
+                                          {
+                                              try
+                                              {
+                                                  promise->set_value(factory());
+                                              }
+                                              catch (...)
+                                              {
+                                                  promise->set_exception(std::current_exception());
+                                              } });
+            return result;
+        }
+
+        /**
+         * @brief Drops the sort cache, called by every mutation.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void invalidateSortCache()
+        {
+            sort_cache.store(std::shared_ptr<const std::vector<T>>());
+            run_cache.store(std::shared_ptr<const std::vector<size_t>>());
+            background.schedule();
+        }
+
+        /**
+         * @brief Drops the elements from a position to the end.
+         * @param new_size Number of elements to keep, at most size().
+         * @returns void
+         * @throw None
+         */
+        void truncate(size_t new_size)
+        {
+            detail::BackgroundSort::Mutation mutation(background);
+            elements.erase(elements.begin() + new_size, elements.end());
+            invalidateSortCache();
+        }
+
+        /**
+         * @brief Shared producer of a sorted traversal.
+         * In eager mode the run reads the container's sort cache (front to back, or back to front for the
+         * reversed order), so starting a traversal over a warm cache costs O(1).
+         * In lazy mode the elements are heapified in O(n) and each new position pops one element
+         * off the heap, so reading the first k elements costs O(n + k log n). Popped elements stay in the heap's
+         * vector, behind the shrinking heap (the order back to front, as in std::sort_heap), so the run holds a
+         * single copy of the elements.
+         * Iterator copies (begin(), end(), post-increment) share one run, so elements are produced only once.
+         * @tparam Compare Strict weak ordering that defines the traversal order (lazy mode).
+         */
+        template <typename Compare>
+        class SortedRun
+        {
+        private:
+            std::shared_ptr<const std::vector<T>> sorted; // Eager mode: the ascending sort cache
+            bool reversed;                                // Eager mode: read sorted back to front
+            std::vector<T> values;                        // Lazy mode: the heap of the rest, then the produced elements in reverse
+            size_t produced;                              // Lazy mode: length of the produced prefix
+            size_t total;                                 // Total number of elements in the run
+
+            // Inverts Compare so that the heap top is the next element of the order
+            struct HeapCompare
+            {
+                bool operator()(const T &a, const T &b) const { return Compare()(b, a); }
+            };
+
+        public:
+            /**
+             * @brief Constructor for an eager SortedRun over the sort cache.
+             * @param sorted The elements in ascending order.
+             * @param reversed true to produce them from largest to smallest.
+             * @returns SortedRun object.
+             * @throw None
+             */
+            SortedRun(std::shared_ptr<const std::vector<T>> sorted, bool reversed)
+                : sorted(sorted), reversed(reversed), produced(0), total(sorted->size()) {}
+
+            /**
+             * @brief Constructor for a lazy SortedRun.
+             * @param source The elements to order.
+             * @returns SortedRun object.
+             * @throw None
+             */
+            explicit SortedRun(const std::vector<T> &source) : reversed(false), values(source), produced(0), total(source.size())
+            {
+                MYCONTAINER_TRACE_SCOPE("heapify", total);
+                std::make_heap(values.begin(), values.end(), HeapCompare());
+            }
+
+            /**
+             * @brief Makes sure the element at the given position has been produced (lazy mode).
+             * @param index Position in the order.
+             * @returns void
+             * @throw None
+             */
+            void ensure(size_t index)
+            {
+                while (produced <= index && produced < total)
+                {
+                    std::pop_heap(values.begin(), values.end() - produced, HeapCompare()); // Lands at values[total - 1 - produced]
+                    ++produced;
+                }
+            }
+
+            /**
+             * @brief Returns the element at the given position, producing it if needed.
+             * @param index Position in the order, must be smaller than size().
+             * @returns A constant reference to the element.
+             * @throw None
+             */
+            const T &at(size_t index)
+            {
+                if (sorted)
+                {
+                    return (*sorted)[reversed ? total - 1 - index : index];
+                }
+                ensure(index);
+                return values[total - 1 - index];
+            }
+
+            /**
+             * @brief Calls fn once per chunk of the order, producing each chunk only when it is reached.
+             *
+             * @note Lazy runs and reversed eager runs gather each chunk into a buffer, which is only valid during the call.
+             *
+             * @param chunk_size Maximum number of elements per span.
+             * @param fn Callable invoked with a Span<T> per chunk.
+             * @returns void
+             * @throw std::invalid_argument if chunk_size is 0.
+             */
+            template <typename Function>
+            void forEachSpan(size_t chunk_size, Function &fn)
+            {
+                if (sorted && !reversed)
+                {
+                    detail::forEachSpanOf(sorted->data(), total, chunk_size, fn);
+                    return;
+                }
+                if (sorted)
+                {
+                    const T *ascending = sorted->data();
+                    const size_t last = total - 1;
+                    detail::forEachGatheredSpan<T>(total, chunk_size, fn, [ascending, last](size_t i) -> const T & { return ascending[last - i]; });
+                    return;
+                }
+                SortedRun *self = this;
+                detail::forEachGatheredSpan<T>(total, chunk_size, fn, [self](size_t i) -> const T & { return self->at(i); }); // Produced back to front
+            }
+
+            /**
+             * @brief Returns the number of elements in the run.
+             * @param None
+             * @returns The size of the run.
+             * @throw None
+             */
+            size_t size() const { return total; }
+        };
+
+    public:
+        /**
+         * @brief Default constructor for MyContainer.
+         * Initializes an empty container.
+         * @param None
+         * @returns MyContainer object.
+         * @throw None
+         */
+        MyContainer()
+        {
+            // Empty - std::vector automatically initializes as empty
+            // note: doing: elements = std::vector<T>(); here is exactly the same as not doing anything
+        }
+
+        /**
+         * @brief Copy and move operations, member by member.
+         *
+         * @note Background sorting (see enableBackgroundSort()) is not carried over: copies start without it,
+         * and assigning to or moving from a container turns it off. A moved-from container is empty, sort cache included.
+         */
+        MyContainer(const MyContainer &) = default;
+        MyContainer(MyContainer &&) = default;
+        MyContainer &operator=(const MyContainer &) = default;
+        MyContainer &operator=(MyContainer &&) = default;
+
+        /**
+         * @brief Destructor, stops the background sort worker before the elements are destroyed.
+         * @param None
+         * @returns None
+         * @throw None
+         */
+        ~MyContainer()
+        {
+            background.stop();
+        }
+
+        /**
+         * @brief Returns the number of elements in the container.
+         * @param None
+         * @returns The size of the container.
+         * @throw None
+         */
+        size_t size() const
+        {
+            return elements.size();
+        }
+
+        /**
+         * @brief Checks if the container is empty.
+         * @param None
+         * @returns true if the container is empty, false otherwise.
+         * @throw None
+         */
+        bool isEmpty() const
+        {
+            return elements.empty();
+        }
+
+        /**
+         * @brief Turns on background sorting: every mutation schedules a rebuild of the sort cache on a worker
+         * thread owned by the container, started once no mutation arrived for the debounce period, so a burst
+         * of add() calls costs one sort and the next sorted traversal finds the cache warm.
+         * A traversal that starts before the rebuild finished sorts by itself, as without background sorting.
+         *
+         * @note While it is on, every mutation takes a lock shared with the worker, which holds it only while
+         * copying the elements. Copies of the container start without background sorting.
+         *
+         * @param debounce Quiet period after the last mutation before the rebuild starts.
+         * @returns void
+         * @throw std::system_error if the worker thread cannot be started.
+         */
+        void enableBackgroundSort(std::chrono::milliseconds debounce = DEFAULT_SORT_DEBOUNCE)
+        {
+            background.start(debounce, [this](std::unique_lock<std::mutex> &held)
+                             { rebuildSortCache(held); });
+            if (!sort_cache.load())
+            {
+                detail::BackgroundSort::Mutation mutation(background);
+                background.schedule();
+            }
+        }
+
+        /**
+         * @brief Turns off background sorting and joins the worker; a rebuild in progress finishes first.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void disableBackgroundSort()
+        {
+            background.stop();
+        }
+
+        /**
+         * @brief Checks if background sorting is on.
+         * @param None
+         * @returns true between enableBackgroundSort() and disableBackgroundSort().
+         * @throw None
+         */
+        bool backgroundSortEnabled() const
+        {
+            return background.enabled();
+        }
+
+        /**
+         * @brief Blocks until no background rebuild of the sort cache is scheduled or running.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void waitForBackgroundSort() const
+        {
+            background.waitIdle();
+        }
+
+        /**
+         * @brief Prints the elements of the container to standard output, followed by a newline.
+         *
+         * @note An << operator overload is also provided for streaming(at the end of the file).
+         *
+         * @param separator Text written after every element.
+         * @returns void
+         * @throw None
+         */
+        void print(const std::string &separator = " ") const
+        {
+            writeTo(std::cout, separator);
+            std::cout << '\n';
+        }
+
+        /**
+         * @brief Writes the elements in insertion order to a stream, each followed by the separator.
+         * Arithmetic types and std::string are formatted into one local buffer and written in bulk;
+         * the text is identical to streaming the elements one by one.
+         * @param os The output stream.
+         * @param separator Text written after every element.
+         * @returns void
+         * @throw Whatever T's operator<< throws.
+         */
+        void writeTo(std::ostream &os, const std::string &separator = " ") const
+        {
+            const T *src = elements.data();
+            detail::writeFormatted(os, elements.size(), [src](size_t i) -> const T & { return src[i]; }, separator);
+        }
+
+        /**
+         * @brief Adds an element to the container.
+         * @param element The element to add to the container.
+         * @returns void
+         * @throw None
+         */
+        void add(const T &element)
+        {
+            MYCONTAINER_LATENCY_SCOPE(LatencyOp::Add);
+            MYCONTAINER_STAT(statistics.adds.fetch_add(1, std::memory_order_relaxed));
+            detail::BackgroundSort::Mutation mutation(background);
+            elements.push_back(element);
+            invalidateSortCache();
+        }
+
+        /**
+         * @brief Removes all occurrences of the specified element from the container.
+         * @param element The element to remove from the container.
+         * @returns void
+         * @throw std::runtime_error if the element is not found.
+         */
+
+        void remove(const T &element)
+        {
+            MYCONTAINER_TRACE_SCOPE("remove", elements.size());
+            MYCONTAINER_LATENCY_SCOPE(LatencyOp::Remove);
+            // First check if element exists
+            auto found = std::find(elements.begin(), elements.end(), element);
+            /**
+             * @note alternatively, we could have written:
+             * typename std::vector<T>::iterator found = std::find(elements.begin(), elements.end(), element);
+             */
+            if (found == elements.end())
+            {
+                MYCONTAINER_STAT(statistics.remove_misses.fetch_add(1, std::memory_order_relaxed));
+                throw std::invalid_argument("Element not found in container");
+            }
+            MYCONTAINER_STAT(statistics.removes.fetch_add(1, std::memory_order_relaxed));
+            detail::BackgroundSort::Mutation mutation(background);
+            // Remove all occurrences
+            auto new_end = std::remove(elements.begin(), elements.end(), element);
+            /**
+             * @note alternatively, we could have written:
+             * typename std::vector<T>::iterator new_end = std::remove(elements.begin(), elements.end(), element);
+             */
+            elements.erase(new_end, elements.end());
+            invalidateSortCache();
+        }
+
+        /**
+         * @brief Counts the occurrences of an element.
+         * @param element The element to count.
+         * @returns Number of elements equal to element.
+         * @throw None
+         */
+        size_t count(const T &element) const
+        {
+            return static_cast<size_t>(std::count(elements.begin(), elements.end(), element));
+        }
+
+        /**
+         * @brief Returns a constant reference to the elements vector.
+         * This allows read-only access to the elements stored in the container.
+         * @param None
+         * @returns const std::vector<T>& - reference to the elements vector.
+         * @throw None
+         */
+        const std::vector<T> &getElements() const { return elements; }
+
+        /**
+         * @brief Saves the elements, in insertion order, to a binary file.
+         * The format is a versioned header (element count, payload size, checksum) followed by the raw elements
+         * for trivially copyable T, or by length-prefixed strings for std::string.
+         * Optionally the sorted index (ascending permutation and run boundaries) is stored as well, so that
+         * load() can warm the sort cache without sorting.
+         *
+         * @note Only available for trivially copyable T and std::string. Files use the host byte order.
+         * Storing the index costs one O(n log n) index sort at save time.
+         *
+         * @param path The file to write (replaced atomically if it exists).
+         * @param with_sorted_index true to store the sorted index after the elements.
+         * @returns void
+         * @throw std::runtime_error if the file cannot be written.
+         */
+        void save(const std::string &path, bool with_sorted_index = false) const
+        {
+            MYCONTAINER_TRACE_SCOPE("save", elements.size());
+            if (!with_sorted_index)
+            {
+                detail::saveElements(path, elements);
+                return;
+            }
+            detail::SortedIndex index;
+            detail::ascendingPermutation(elements.data(), elements.size(), index.permutation);
+            std::shared_ptr<const std::vector<T>> sorted = sort_cache.load();
+            if (!sorted)
+            {
+                // The permutation already orders the elements, so warm the cache from it instead of sorting again
+                std::shared_ptr<std::vector<T>> gathered = std::make_shared<std::vector<T>>(elements.size());
+                for (size_t i = 0; i < elements.size(); ++i)
+                {
+                    (*gathered)[i] = elements[index.permutation[i]];
+                }
+                MYCONTAINER_STAT(statistics.recordCopy(elements.size(), sizeof(T)));
+                sort_cache.store(gathered);
+                sorted = gathered;
+            }
+            index.run_starts = *sortedRunStarts(*sorted);
+            detail::saveElements(path, elements, &index);
+        }
+
+        /**
+         * @brief Replaces the contents of the container with the elements of a file written by save().
+         * The file is memory-mapped, so loading costs page faults plus one copy of the payload instead of parsing.
+         * When the file holds a sorted index the sort cache is rebuilt from it in O(n), so the sorted orders
+         * start without sorting right after loading.
+         *
+         * @note Only available for trivially copyable T and std::string.
+         *
+         * @param path The file to read.
+         * @returns void
+         * @throw std::runtime_error if the file cannot be read, was saved with another element type, is truncated,
+         *        fails a checksum or holds a sorted index that does not order its elements.
+         *        The container is unchanged in that case.
+         */
+        void load(const std::string &path)
+        {
+            std::vector<T> loaded;
+            detail::SortedIndex index;
+            detail::loadElements(path, loaded, &index);
+            if (index.permutation.empty())
+            {
+                detail::BackgroundSort::Mutation mutation(background);
+                elements.swap(loaded);
+                invalidateSortCache();
+                return;
+            }
+
+            // Rebuild the sort cache from the permutation, checking that it really orders the elements
+            const size_t count = loaded.size();
+            std::shared_ptr<std::vector<T>> sorted = std::make_shared<std::vector<T>>(count);
+            std::vector<bool> seen(count, false);
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t source = index.permutation[i];
+                if (source >= count || seen[source])
+                {
+                    throw std::runtime_error("Sorted index is not a permutation: " + path);
+                }
+                seen[source] = true;
+                (*sorted)[i] = loaded[source];
+            }
+            std::shared_ptr<std::vector<size_t>> starts = std::make_shared<std::vector<size_t>>();
+            starts->swap(index.run_starts);
+            size_t next_run = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i != 0 && (*sorted)[i] < (*sorted)[i - 1])
+                {
+                    throw std::runtime_error("Sorted index does not order the elements: " + path);
+                }
+                bool run_start = i == 0 || !((*sorted)[i] == (*sorted)[i - 1]);
+                if (run_start != (next_run < starts->size() && (*starts)[next_run] == i))
+                {
+                    throw std::runtime_error("Sorted index has wrong run boundaries: " + path);
+                }
+                next_run += run_start;
+            }
+            if (next_run != starts->size())
+            {
+                throw std::runtime_error("Sorted index has wrong run boundaries: " + path);
+            }
+            detail::BackgroundSort::Mutation mutation(background);
+            elements.swap(loaded);
+            sort_cache.store(sorted);
+            run_cache.store(starts);
+        }
+
+        /**
+         * @brief Appends every whitespace-separated value of a text stream, in stream order.
+         * The stream is read in 64 KiB blocks and parsed in place (integers by a hand-written decimal parser,
+         * floating point values by strtold, std::string tokens as-is, characters one per non-whitespace
+         * character), replacing a user-written "while (in >> x) add(x);" loop. Other types are parsed with
+         * their own operator>>, one token at a time.
+         *
+         * @note Values are appended as they are parsed, in batches of one block, without per-element add() calls.
+         *
+         * @param in The stream to read until its end.
+         * @returns Number of elements appended.
+         * @throw std::invalid_argument if a token is not a valid value of T (e.g. out of range).
+         *        The container is unchanged in that case.
+         */
+        size_t ingest(std::istream &in)
+        {
+            MYCONTAINER_TRACE_SCOPE("ingest", elements.size());
+            const size_t before = elements.size();
+            detail::BackgroundSort::Mutation mutation(background);
+            try
+            {
+                detail::ingestStream(in, elements);
+            }
+            catch (...)
+            {
+                elements.erase(elements.begin() + before, elements.end()); // Drop the part of the stream parsed before the bad token
+                throw;
+            }
+            invalidateSortCache();
+            return elements.size() - before;
+        }
+
+        /**
+         * @brief Appends every whitespace-separated value of a text file, in file order.
+         * The file is memory-mapped and parsed without copying it. With threads > 1 the file is cut into one
+         * piece per thread at whitespace boundaries, the pieces are parsed concurrently and appended in order;
+         * files smaller than 4 KiB per thread are parsed on the calling thread.
+         *
+         * @param path The file to read.
+         * @param threads Number of parsing threads (0 and 1 parse on the calling thread).
+         * @returns Number of elements appended.
+         * @throw std::runtime_error if the file cannot be read.
+         * @throw std::invalid_argument if a token is not a valid value of T. The container is unchanged in that case.
+         */
+        size_t ingestFile(const std::string &path, unsigned threads = 1)
+        {
+            MYCONTAINER_TRACE_SCOPE("ingest", elements.size());
+            detail::MappedFile file(path);
+            const char *text = reinterpret_cast<const char *>(file.data());
+            const size_t before = elements.size();
+            detail::BackgroundSort::Mutation mutation(background);
+            try
+            {
+                detail::parseRangeParallel(text, text + file.size(), threads, elements);
+            }
+            catch (...)
+            {
+                elements.erase(elements.begin() + before, elements.end());
+                throw;
+            }
+            invalidateSortCache();
+            return elements.size() - before;
+        }
+
+        /**
+         * @brief Writes the elements in the given order straight into a caller-provided buffer.
+         * No iterator snapshot is built: runs are copied with memcpy when T is trivially copyable,
+         * and the sorted orders are copied from the sort cache (sorting only if it is stale).
+         *
+         * @note For types that are not trivially copyable, out must point to size() constructed elements.
+         *
+         * @param kind The order to write.
+         * @param out Destination with room for size() elements.
+         * @returns void
+         * @throw std::invalid_argument if kind is not a valid OrderKind.
+         */
+        void materialize(OrderKind kind, T *out) const
+        {
+            const size_t count = elements.size();
+            const T *src = elements.data();
+            switch (kind)
+            {
+            case OrderKind::AscendingOrder:
+            {
+                std::shared_ptr<const std::vector<T>> sorted = sortedElements();
+                detail::copyRun(sorted->data(), count, out);
+                return;
+            }
+            case OrderKind::DescendingOrder:
+            {
+                std::shared_ptr<const std::vector<T>> sorted = sortedElements();
+                std::reverse_copy(sorted->begin(), sorted->end(), out);
+                return;
+            }
+            case OrderKind::SideCrossOrder:
+            {
+                std::shared_ptr<const std::vector<T>> sorted = sortedElements();
+                for (size_t position = 0; position < count; ++position)
+                {
+                    out[position] = (*sorted)[detail::sideCrossIndex(position, count)];
+                }
+                return;
+            }
+            case OrderKind::ReverseOrder:
+                std::reverse_copy(elements.begin(), elements.end(), out);
+                return;
+            case OrderKind::Order:
+                detail::copyRun(src, count, out);
+                return;
+            case OrderKind::MiddleOutOrder:
+                for (size_t position = 0; position < count; ++position)
+                {
+                    out[position] = src[detail::middleOutIndex(position, count)];
+                }
+                return;
+            }
+            throw std::invalid_argument("Unknown order kind");
+        }
+
+        /**
+         * @brief Writes the elements in the given order into a vector.
+         * The vector is resized to size() and its previous contents are replaced.
+         * @param kind The order to write.
+         * @param out The destination vector.
+         * @returns void
+         * @throw std::invalid_argument if kind is not a valid OrderKind.
+         */
+        void copyOrderTo(OrderKind kind, std::vector<T> &out) const
+        {
+            out.resize(elements.size());
+            materialize(kind, out.data());
+        }
+
+        /**
+         * @brief Writes the elements in the given order to a stream, each followed by the separator.
+         * Uses the same buffered formatting as writeTo(); every order is written without a snapshot,
+         * the sorted orders straight from the sort cache.
+         * @param os The output stream.
+         * @param kind The order to write.
+         * @param separator Text written after every element.
+         * @returns void
+         * @throw std::invalid_argument if kind is not a valid OrderKind.
+         */
+        void writeOrder(std::ostream &os, OrderKind kind, const std::string &separator = " ") const
+        {
+            const size_t count = elements.size();
+            const T *src = elements.data();
+            switch (kind)
+            {
+            case OrderKind::Order:
+                detail::writeFormatted(os, count, [src](size_t i) -> const T & { return src[i]; }, separator);
+                return;
+            case OrderKind::ReverseOrder:
+                detail::writeFormatted(os, count, [src, count](size_t i) -> const T & { return src[count - 1 - i]; }, separator);
+                return;
+            case OrderKind::MiddleOutOrder:
+                detail::writeFormatted(os, count, [src, count](size_t i) -> const T & { return src[detail::middleOutIndex(i, count)]; }, separator);
+                return;
+            case OrderKind::AscendingOrder:
+            case OrderKind::DescendingOrder:
+            case OrderKind::SideCrossOrder:
+            {
+                std::shared_ptr<const std::vector<T>> sorted = sortedElements();
+                const T *ascending = sorted->data();
+                if (kind == OrderKind::AscendingOrder)
+                {
+                    detail::writeFormatted(os, count, [ascending](size_t i) -> const T & { return ascending[i]; }, separator);
+                }
+                else if (kind == OrderKind::DescendingOrder)
+                {
+                    detail::writeFormatted(os, count, [ascending, count](size_t i) -> const T & { return ascending[count - 1 - i]; }, separator);
+                }
+                else
+                {
+                    detail::writeFormatted(os, count, [ascending, count](size_t i) -> const T & { return ascending[detail::sideCrossIndex(i, count)]; }, separator);
+                }
+                return;
+            }
+            }
+            throw std::invalid_argument("Unknown order kind");
+        }
+
+#ifdef MYCONTAINER_STATS
+        /**
+         * @brief Returns the instrumentation counters of this container.
+         *
+         * @note Only available when compiled with -DMYCONTAINER_STATS.
+         *
+         * @param None
+         * @returns const ContainerStats& - the counters (see ContainerStats::toText() and ContainerStats::toJson()).
+         * @throw None
+         */
+        const ContainerStats &stats() const { return statistics; }
+
+        /**
+         * @brief Sets every instrumentation counter of this container back to zero.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void resetStats() const { statistics.reset(); }
+#endif
+
+        // Default number of elements per span handed out by forEachSpan()
+        static const size_t DEFAULT_SPAN_SIZE = 4096;
+
+        /**
+         * @brief A distinct value together with its number of occurrences.
+         * Produced by the GroupedAscendingOrder iterator.
+         */
+        struct ValueCount
+        {
+            T value;      // The distinct value
+            size_t count; // Number of occurrences of value in the container
+        };
+
+        // == Iterator Classes with Full Implementations ==
+
+        /**
+         * @brief Nested AscendingOrder Iterator Class
+         * Traverses elements from smallest to largest
+         */
+        class AscendingOrder
+        {
+        private:
+            std::shared_ptr<SortedRun<std::less<T>>> run; // Shared with every copy of this iterator
+            size_t current_index;
+
+        public:
+            /**
+             * @brief Constructor for the AscendingOrder iterator.
+             * Initializes the iterator over the container's sort cache, sorting only if the cache is stale.
+             *
+             * @note In lazy mode with a stale cache a copy is only heapified, and elements are sorted one by one
+             * as the iterator advances.
+             *
+             * @param container The MyContainer instance to iterate over.
+             * @param lazy true to produce the order on demand (see getLazyAscendingOrder()), false to sort everything now.
+             * @returns AscendingOrder object.
+             * @throw None
+             */
+            AscendingOrder(const MyContainer &container, bool lazy = false) : current_index(0)
+            {
+                MYCONTAINER_SNAPSHOT_SCOPE(container, static_cast<size_t>(OrderKind::AscendingOrder));
+                if (lazy && !container.sort_cache.load())
+                {
+                    MYCONTAINER_STAT(container.statistics.recordCopy(container.elements.size(), sizeof(T)));
+                    run = std::make_shared<SortedRun<std::less<T>>>(container.elements);
+                    return;
+                }
+                run = std::make_shared<SortedRun<std::less<T>>>(container.sortedElements(), false);
+            }
+
+            /**
+             * @brief Pre-increment operator for the AscendingOrder iterator.
+             * @param None
+             * @returns Reference to the current AscendingOrder object after incrementing.
+             * @throw None
+             */
+            AscendingOrder &operator++()
+            {
+                ++current_index;
+                return *this;
+            }
+
+            /**
+             * @brief Post-increment operator for the AscendingOrder iterator.
+             * @param None
+             * @returns A copy of the AscendingOrder object before incrementing.
+             * @throw None
+             */
+            AscendingOrder operator++(int)
+            {
+                AscendingOrder temp = *this;
+                ++current_index;
+                return temp;
+            }
+
+            /**
+             * @brief Dereference operator for the AscendingOrder iterator.
+             * @param None
+             * @returns A constant reference to the current element in the sorted order.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &operator*() const
+            {
+                detail::checkIteratorIndex(current_index, run->size());
+                return run->at(current_index);
+            }
+
+            /**
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The position of end().
+             * @throw None
+             */
+            size_t size() const { return run->size(); }
+
+            /**
+             * @brief Returns the element at a position of the ascending order, in O(1).
+             *
+             * @note In lazy mode this produces the order up to position, so concurrent calls must wait until
+             * at(size() - 1) completed it.
+             *
+             * @param position Position in the order, smaller than size().
+             * @returns A constant reference to the element.
+             * @throw std::out_of_range if position exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &at(size_t position) const
+            {
+                detail::checkIteratorIndex(position, run->size());
+                return run->at(position);
+            }
+
+            /**
+             * @brief Equality operator for the AscendingOrder iterator.
+             * @param other Another AscendingOrder iterator to compare with.
+             * @returns true if both iterators point to the same index, false otherwise.
+             */
+            bool operator==(const AscendingOrder &other) const
+            {
+                return current_index == other.current_index;
+            }
+
+            /**
+             * @brief Inequality operator for the AscendingOrder iterator.
+             * 
+             * @note This function uses the equality operator to determine inequality.
+             * 
+             * @param other Another AscendingOrder iterator to compare with.
+             * @returns true if the iterators point to different indices, false otherwise.
+             * @throw None
+             */
+            bool operator!=(const AscendingOrder &other) const
+            {
+                return !(*this == other);
+            }
+
+            /**
+             * @brief Begin method for the AscendingOrder iterator.
+             * @param None
+             * @returns A new AscendingOrder iterator starting from the first element.
+             * @throw None
+             */
+            AscendingOrder begin()
+            {
+                AscendingOrder iter = *this;
+                iter.current_index = 0;
+                return iter;
+            }
+
+            /**
+             * @brief End method for the AscendingOrder iterator.
+             * @param None
+             * @returns A new AscendingOrder iterator pointing to one past the last element.
+             * @throw None
+             */
+            AscendingOrder end()
+            {
+                AscendingOrder iter = *this;
+                iter.current_index = run->size();
+                return iter;
+            }
+
+            /**
+             * @brief Hands out the ascending order in contiguous spans.
+             * Lets vectorized consumers run over plain arrays instead of calling operator* per element.
+             *
+             * @note In lazy mode each span is gathered from the heap's produced elements and is only valid during the call.
+             *
+             * @param fn Callable invoked as fn(Span<T>) once per chunk, in traversal order.
+             * @param chunk_size Maximum number of elements per span.
+             * @returns void
+             * @throw std::invalid_argument if chunk_size is 0.
+             */
+            template <typename Function>
+            void forEachSpan(Function fn, size_t chunk_size = DEFAULT_SPAN_SIZE) const
+            {
+                run->forEachSpan(chunk_size, fn);
+            }
+        };
+
+        /**
+         * @brief Nested DescendingOrder Iterator Class
+         * Traverses elements from largest to smallest
+         */
+        class DescendingOrder
+        {
+        private:
+            std::shared_ptr<SortedRun<std::greater<T>>> run; // Shared with every copy of this iterator
+            size_t current_index;
+
+        public:
+            /**
+             * @brief Constructor for the DescendingOrder iterator.
+             * Reads the container's sort cache back to front, sorting only if the cache is stale.
+             *
+             * @note In lazy mode with a stale cache a copy is only heapified, and elements are sorted one by one
+             * as the iterator advances.
+             *
+             * @param container The MyContainer instance to iterate over.
+             * @param lazy true to produce the order on demand (see getLazyDescendingOrder()), false to sort everything now.
+             * @returns DescendingOrder object.
+             * @throw None
+             */
+            DescendingOrder(const MyContainer &container, bool lazy = false) : current_index(0)
+            {
+                MYCONTAINER_SNAPSHOT_SCOPE(container, static_cast<size_t>(OrderKind::DescendingOrder));
+                if (lazy && !container.sort_cache.load())
+                {
+                    MYCONTAINER_STAT(container.statistics.recordCopy(container.elements.size(), sizeof(T)));
+                    run = std::make_shared<SortedRun<std::greater<T>>>(container.elements);
+                    return;
+                }
+                run = std::make_shared<SortedRun<std::greater<T>>>(container.sortedElements(), true);
+            }
+
+            /**
+             * @brief Pre-increment operator for the DescendingOrder iterator.
+             * @param None
+             * @returns Reference to the current DescendingOrder object after incrementing.
+             * @throw None
+             */
+            DescendingOrder &operator++()
+            {
+                ++current_index;
+                return *this;
+            }
+
+            /**
+             * @brief Post-increment operator for the DescendingOrder iterator.
+             * @param None
+             * @returns A copy of the DescendingOrder object before incrementing.
+             * @throw None
+             */
+            DescendingOrder operator++(int)
+            {
+                DescendingOrder temp = *this;
+                ++current_index;
+                return temp;
+            }
+
+            /**
+             * @brief Dereference operator for the DescendingOrder iterator.
+             * @param None
+             * @returns A constant reference to the current element in the sorted order.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &operator*() const
+            {
+                detail::checkIteratorIndex(current_index, run->size());
+                return run->at(current_index);
+            }
+
+            /**
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The position of end().
+             * @throw None
+             */
+            size_t size() const { return run->size(); }
+
+            /**
+             * @brief Returns the element at a position of the descending order, in O(1).
+             *
+             * @note In lazy mode this produces the order up to position, so concurrent calls must wait until
+             * at(size() - 1) completed it.
+             *
+             * @param position Position in the order, smaller than size().
+             * @returns A constant reference to the element.
+             * @throw std::out_of_range if position exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &at(size_t position) const
+            {
+                detail::checkIteratorIndex(position, run->size());
+                return run->at(position);
+            }
+
+            /**
+             * @brief Equality operator for the DescendingOrder iterator.
+             * @param other Another DescendingOrder iterator to compare with.
+             * @returns true if both iterators point to the same index, false otherwise.
+             */
+            bool operator==(const DescendingOrder &other) const
+            {
+                return current_index == other.current_index;
+            }
+
+            /**
+             * @brief Inequality operator for the DescendingOrder iterator.
+             * 
+             * @note This function uses the equality operator to determine inequality.
+             * 
+             * @param other Another DescendingOrder iterator to compare with.
+             * @returns true if the iterators point to different indices, false otherwise.
+             * @throw None
+             */
+            bool operator!=(const DescendingOrder &other) const
+            {
+                return !(*this == other);
+            }
+
+            /**
+             * @brief Begin method for the DescendingOrder iterator.
+             * @param None
+             * @returns A new DescendingOrder iterator starting from the first element.
+             * @throw None
+             */
+            DescendingOrder begin()
+            {
+                DescendingOrder iter = *this;
+                iter.current_index = 0;
+                return iter;
+            }
+
+            /**
+             * @brief End method for the DescendingOrder iterator.
+             * @param None
+             * @returns A new DescendingOrder iterator pointing to one past the last element.
+             * @throw None
+             */
+            DescendingOrder end()
+            {
+                DescendingOrder iter = *this;
+                iter.current_index = run->size();
+                return iter;
+            }
+
+            /**
+             * @brief Hands out the descending order in contiguous spans.
+             * Lets vectorized consumers run over plain arrays instead of calling operator* per element.
+             *
+             * @note Each span is gathered (from the sort cache, or in lazy mode from the heap's produced elements) and
+             * is only valid during the call.
+             *
+             * @param fn Callable invoked as fn(Span<T>) once per chunk, in traversal order.
+             * @param chunk_size Maximum number of elements per span.
+             * @returns void
+             * @throw std::invalid_argument if chunk_size is 0.
+             */
+            template <typename Function>
+            void forEachSpan(Function fn, size_t chunk_size = DEFAULT_SPAN_SIZE) const
+            {
+                run->forEachSpan(chunk_size, fn);
+            }
+        };
+
+        /**
+         * @brief Nested SideCrossOrder Iterator Class
+         * Alternates between smallest and largest remaining elements
          */
-        size_t size() const
+        class SideCrossOrder
         {
-            return elements.size();
-        }
+        private:
+            std::shared_ptr<const std::vector<T>> sorted_elements; // The container's sort cache, read through sideCrossIndex()
+            size_t current_index;
 
-        /**
-         * @brief Checks if the container is empty.
-         * @param None
-         * @returns true if the container is empty, false otherwise.
-         * @throw None
-         */
-        bool isEmpty() const
-        {
-            return elements.empty();
-        }
+        public:
+            /**
+             * @brief Constructor for the SideCrossOrder iterator.
+             * The order (smallest, largest, second smallest, second largest, ...) is an index mapping of the
+             * ascending order, so the iterator reads the container's sort cache instead of arranging a copy.
+             * @param container The MyContainer instance to iterate over.
+             * @returns SideCrossOrder object.
+             * @throw None
+             */
+            SideCrossOrder(const MyContainer &container) : current_index(0)
+            {
+                MYCONTAINER_SNAPSHOT_SCOPE(container, static_cast<size_t>(OrderKind::SideCrossOrder));
+                sorted_elements = container.sortedElements();
+            }
 
-        /**
-         * @brief Prints the elements of the container to standard output.
-         *
-         * @note An << operator overload is also provided for streaming(at the end of the file).
-         *
-         * @param None
-         * @returns void
-         * @throw None
-         */
-        void print() const
-        {
-            for (const auto &elem : elements)
+            /**
+             * @brief Pre-increment operator for the SideCrossOrder iterator.
+             * @param None
+             * @returns Reference to the current SideCrossOrder object after incrementing.
+             * @throw None
+             */
+            SideCrossOrder &operator++()
             {
-                std::cout << elem << " ";
+                ++current_index;
+                return *this;
             }
-            std::cout << std::endl;
-        }
 
-        /**
-         * @brief Adds an element to the container.
-         * @param element The element to add to the container.
-         * @returns void
-         * @throw None
-         */
-        void add(const T &element)
-        {
-            elements.push_back(element);
-        }
+            /**
+             * @brief Post-increment operator for the SideCrossOrder iterator.
+             * @param None
+             * @returns A copy of the SideCrossOrder object before incrementing.
+             * @throw None
+             */
+            SideCrossOrder operator++(int)
+            {
+                SideCrossOrder temp = *this;
+                ++current_index;
+                return temp;
+            }
 
-        /**
-         * @brief Removes all occurrences of the specified element from the container.
-         * @param element The element to remove from the container.
-         * @returns void
-         * @throw std::runtime_error if the element is not found.
-         */
+            /**
+             * @brief Dereference operator for the SideCrossOrder iterator.
+             * @param None
+             * @returns A constant reference to the current element in the side-cross order.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &operator*() const
+            {
+                detail::checkIteratorIndex(current_index, sorted_elements->size());
+                return (*sorted_elements)[detail::sideCrossIndex(current_index, sorted_elements->size())];
+            }
 
-        void remove(const T &element)
-        {
-            // First check if element exists
-            auto found = std::find(elements.begin(), elements.end(), element);
             /**
-             * @note alternatively, we could have written:
-             * typename std::vector<T>::iterator found = std::find(elements.begin(), elements.end(), element);
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The position of end().
+             * @throw None
              */
-            if (found == elements.end())
+            size_t size() const { return sorted_elements->size(); }
+
+            /**
+             * @brief Returns the element at a position of the side-cross order, in O(1).
+             * @param position Position in the order, smaller than size().
+             * @returns A constant reference to the element.
+             * @throw std::out_of_range if position exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &at(size_t position) const
             {
-                throw std::invalid_argument("Element not found in container");
+                detail::checkIteratorIndex(position, sorted_elements->size());
+                return (*sorted_elements)[detail::sideCrossIndex(position, sorted_elements->size())];
             }
-            // Remove all occurrences
-            auto new_end = std::remove(elements.begin(), elements.end(), element);
+
             /**
-             * @note alternatively, we could have written:
-             * typename std::vector<T>::iterator new_end = std::remove(elements.begin(), elements.end(), element);
+             * @brief Equality operator for the SideCrossOrder iterator.
+             * @param other Another SideCrossOrder iterator to compare with.
+             * @returns true if both iterators point to the same index, false otherwise.
+             * @throw None
              */
-            elements.erase(new_end, elements.end());
-        }
+            bool operator==(const SideCrossOrder &other) const
+            {
+                return current_index == other.current_index;
+            }
 
-        /**
-         * @brief Returns a constant reference to the elements vector.
-         * This allows read-only access to the elements stored in the container.
-         * @param None
-         * @returns const std::vector<T>& - reference to the elements vector.
-         * @throw None
-         */
-        const std::vector<T> &getElements() const { return elements; }
+            /**
+             * @brief Inequality operator for the SideCrossOrder iterator.
+             * 
+             * @note This function uses the equality operator to determine inequality.
+             * 
+             * @param other Another SideCrossOrder iterator to compare with.
+             * @returns true if the iterators point to different indices, false otherwise.
+             * @throw None
+             */
+            bool operator!=(const SideCrossOrder &other) const
+            {
+                return !(*this == other);
+            }
 
-        // == Iterator Classes with Full Implementations ==
+            /**
+             * @brief Begin method for the SideCrossOrder iterator.
+             * @param None
+             * @returns A new SideCrossOrder iterator starting from the first element.
+             * @throw None
+             */
+            SideCrossOrder begin()
+            {
+                SideCrossOrder iter = *this;
+                iter.current_index = 0;
+                return iter;
+            }
+
+            /**
+             * @brief End method for the SideCrossOrder iterator.
+             * @param None
+             * @returns A new SideCrossOrder iterator pointing to one past the last element.
+             * @throw None
+             */
+            SideCrossOrder end()
+            {
+                SideCrossOrder iter = *this;
+                iter.current_index = sorted_elements->size();
+                return iter;
+            }
+
+            /**
+             * @brief Hands out the side-cross order in contiguous spans.
+             * Lets vectorized consumers run over plain arrays instead of calling operator* per element.
+             *
+             * @note Each span is gathered from the sort cache and is only valid during the call.
+             *
+             * @param fn Callable invoked as fn(Span<T>) once per chunk, in traversal order.
+             * @param chunk_size Maximum number of elements per span.
+             * @returns void
+             * @throw std::invalid_argument if chunk_size is 0.
+             */
+            template <typename Function>
+            void forEachSpan(Function fn, size_t chunk_size = DEFAULT_SPAN_SIZE) const
+            {
+                const T *ascending = sorted_elements->data();
+                const size_t count = sorted_elements->size();
+                detail::forEachGatheredSpan<T>(count, chunk_size, fn, [ascending, count](size_t i) -> const T & { return ascending[detail::sideCrossIndex(i, count)]; });
+            }
+        };
 
         /**
-         * @brief Nested AscendingOrder Iterator Class
-         * Traverses elements from smallest to largest
+         * @brief Nested ReverseOrder Iterator Class
+         * Traverses elements in reverse insertion order
          */
-        class AscendingOrder
+        class ReverseOrder
         {
         private:
-            std::vector<T> sorted_elements;
+            std::shared_ptr<const std::vector<T>> reverse_elements; // Shared with every copy of this iterator
             size_t current_index;
 
         public:
             /**
-             * @brief Constructor for the AscendingOrder iterator.
-             * Initializes the iterator with a sorted copy of the container's elements.
+             * @brief Constructor for the ReverseOrder iterator.
              * @param container The MyContainer instance to iterate over.
-             * @returns AscendingOrder object.
+             * @returns ReverseOrder object.
              * @throw None
              */
-            AscendingOrder(const MyContainer &container) : sorted_elements(container.elements), current_index(0)
+            ReverseOrder(const MyContainer &container) : current_index(0)
             {
-                // Sort the elements in ascending order
-                std::sort(sorted_elements.begin(), sorted_elements.end(),std::less<T>());
+                MYCONTAINER_SNAPSHOT_SCOPE(container, static_cast<size_t>(OrderKind::ReverseOrder));
+                std::vector<T> arranged;
+                // Copy elements in reverse order
+                arranged.reserve(container.elements.size()); // Reserve space for efficiency(allicate once)
+                for (auto it = container.elements.rbegin(); it != container.elements.rend(); ++it)
+                {
+                    arranged.push_back(*it);
+                }
+
+                MYCONTAINER_STAT(container.statistics.recordCopy(arranged.size(), sizeof(T)));
+                reverse_elements = std::make_shared<const std::vector<T>>(std::move(arranged));
             }
 
             /**
-             * @brief Pre-increment operator for the AscendingOrder iterator.
+             * @brief Pre-increment operator for the ReverseOrder iterator.
              * @param None
-             * @returns Reference to the current AscendingOrder object after incrementing.
+             * @returns Reference to the current ReverseOrder object after incrementing.
              * @throw None
              */
-            AscendingOrder &operator++()
+            ReverseOrder &operator++()
             {
                 ++current_index;
                 return *this;
             }
 
             /**
-             * @brief Post-increment operator for the AscendingOrder iterator.
+             * @brief Post-increment operator for the ReverseOrder iterator.
              * @param None
-             * @returns A copy of the AscendingOrder object before incrementing.
+             * @returns A copy of the ReverseOrder object before incrementing.
              * @throw None
              */
-            AscendingOrder operator++(int)
+            ReverseOrder operator++(int)
             {
-                AscendingOrder temp = *this;
+                ReverseOrder temp = *this;
                 ++current_index;
                 return temp;
             }
 
             /**
-             * @brief Dereference operator for the AscendingOrder iterator.
+             * @brief Dereference operator for the ReverseOrder iterator.
              * @param None
-             * @returns A constant reference to the current element in the sorted order.
-             * @throw std::out_of_range if the current index exceeds the size of sorted_elements.
+             * @returns A constant reference to the current element in reverse order.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
              */
             const T &operator*() const
             {
-                if (current_index >= sorted_elements.size())
-                {
-                    throw std::out_of_range("Iterator out of range");
-                }
-                return sorted_elements[current_index];
+                detail::checkIteratorIndex(current_index, reverse_elements->size());
+                return (*reverse_elements)[current_index];
             }
 
             /**
-             * @brief Equality operator for the AscendingOrder iterator.
-             * @param other Another AscendingOrder iterator to compare with.
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The position of end().
+             * @throw None
+             */
+            size_t size() const { return reverse_elements->size(); }
+
+            /**
+             * @brief Returns the element at a position of the reverse order, in O(1).
+             * @param position Position in the order, smaller than size().
+             * @returns A constant reference to the element.
+             * @throw std::out_of_range if position exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &at(size_t position) const
+            {
+                detail::checkIteratorIndex(position, reverse_elements->size());
+                return (*reverse_elements)[position];
+            }
+
+            /**
+             * @brief Equality operator for the ReverseOrder iterator.
+             * @param other Another ReverseOrder iterator to compare with.
              * @returns true if both iterators point to the same index, false otherwise.
+             * @throw None
              */
-            bool operator==(const AscendingOrder &other) const
+            bool operator==(const ReverseOrder &other) const
             {
                 return current_index == other.current_index;
             }
 
             /**
-             * @brief Inequality operator for the AscendingOrder iterator.
+             * @brief Inequality operator for the ReverseOrder iterator.
              * 
              * @note This function uses the equality operator to determine inequality.
              * 
-             * @param other Another AscendingOrder iterator to compare with.
+             * @param other Another ReverseOrder iterator to compare with.
              * @returns true if the iterators point to different indices, false otherwise.
              * @throw None
              */
-            bool operator!=(const AscendingOrder &other) const
+            bool operator!=(const ReverseOrder &other) const
             {
                 return !(*this == other);
             }
 
             /**
-             * @brief Begin method for the AscendingOrder iterator.
+             * @brief Begin method for the ReverseOrder iterator.
              * @param None
-             * @returns A new AscendingOrder iterator starting from the first element.
+             * @returns A new ReverseOrder iterator starting from the first element.
              * @throw None
              */
-            AscendingOrder begin()
+            ReverseOrder begin()
             {
-                AscendingOrder iter = *this;
+                ReverseOrder iter = *this;
                 iter.current_index = 0;
                 return iter;
             }
 
             /**
-             * @brief End method for the AscendingOrder iterator.
+             * @brief End method for the ReverseOrder iterator.
              * @param None
-             * @returns A new AscendingOrder iterator pointing to one past the last element.
+             * @returns A new ReverseOrder iterator pointing to one past the last element.
              * @throw None
              */
-            AscendingOrder end()
+            ReverseOrder end()
             {
-                AscendingOrder iter = *this;
-                iter.current_index = sorted_elements.size();
+                ReverseOrder iter = *this;
+                iter.current_index = reverse_elements->size();
                 return iter;
             }
+
+            /**
+             * @brief Hands out the reverse insertion order in contiguous spans.
+             * Lets vectorized consumers run over plain arrays instead of calling operator* per element.
+             * @param fn Callable invoked as fn(Span<T>) once per chunk, in traversal order.
+             * @param chunk_size Maximum number of elements per span.
+             * @returns void
+             * @throw std::invalid_argument if chunk_size is 0.
+             */
+            template <typename Function>
+            void forEachSpan(Function fn, size_t chunk_size = DEFAULT_SPAN_SIZE) const
+            {
+                detail::forEachSpanOf(reverse_elements->data(), reverse_elements->size(), chunk_size, fn);
+            }
         };
 
         /**
-         * @brief Nested DescendingOrder Iterator Class
-         * Traverses elements from largest to smallest
+         * @brief Nested Order Iterator Class
+         * Traverses elements in original insertion order
          */
-        class DescendingOrder
+        class Order
         {
         private:
-            std::vector<T> sorted_elements;
+            std::shared_ptr<const std::vector<T>> original_elements; // Shared with every copy of this iterator
             size_t current_index;
 
         public:
             /**
-             * @brief Constructor for the DescendingOrder iterator.
+             * @brief Constructor for the Order iterator.
              * @param container The MyContainer instance to iterate over.
-             * @returns DescendingOrder object.
+             * @returns Order object.
              * @throw None
              */
-            DescendingOrder(const MyContainer &container): sorted_elements(container.elements), current_index(0)
+            Order(const MyContainer &container) : current_index(0)
             {
-                // Sort the elements in descending order (largest to smallest)
-                std::sort(sorted_elements.begin(), sorted_elements.end(), std::greater<T>());
+                MYCONTAINER_SNAPSHOT_SCOPE(container, static_cast<size_t>(OrderKind::Order));
+                // Simply copy elements in their original order - no sorting needed
+                original_elements = std::make_shared<const std::vector<T>>(container.elements);
+                MYCONTAINER_STAT(container.statistics.recordCopy(container.elements.size(), sizeof(T)));
             }
 
             /**
-             * @brief Pre-increment operator for the DescendingOrder iterator.
+             * @brief Pre-increment operator for the Order iterator.
              * @param None
-             * @returns Reference to the current DescendingOrder object after incrementing.
+             * @returns Reference to the current Order object after incrementing.
              * @throw None
              */
-            DescendingOrder &operator++()
+            Order &operator++()
             {
                 ++current_index;
                 return *this;
             }
 
             /**
-             * @brief Post-increment operator for the DescendingOrder iterator.
+             * @brief Post-increment operator for the Order iterator.
              * @param None
-             * @returns A copy of the DescendingOrder object before incrementing.
+             * @returns A copy of the Order object before incrementing.
              * @throw None
              */
-            DescendingOrder operator++(int)
+            Order operator++(int)
             {
-                DescendingOrder temp = *this;
+                Order temp = *this;
                 ++current_index;
                 return temp;
             }
 
             /**
-             * @brief Dereference operator for the DescendingOrder iterator.
+             * @brief Dereference operator for the Order iterator.
              * @param None
-             * @returns A constant reference to the current element in the sorted order.
-             * @throw std::out_of_range if the current index exceeds the size of sorted_elements.
+             * @returns A constant reference to the current element in original order.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
              */
             const T &operator*() const
             {
-                if (current_index >= sorted_elements.size())
-                {
-                    throw std::out_of_range("Iterator out of range");
-                }
-                return sorted_elements[current_index];
+                detail::checkIteratorIndex(current_index, original_elements->size());
+                return (*original_elements)[current_index];
             }
 
             /**
-             * @brief Equality operator for the DescendingOrder iterator.
-             * @param other Another DescendingOrder iterator to compare with.
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The position of end().
+             * @throw None
+             */
+            size_t size() const { return original_elements->size(); }
+
+            /**
+             * @brief Returns the element at a position of the insertion order, in O(1).
+             * @param position Position in the order, smaller than size().
+             * @returns A constant reference to the element.
+             * @throw std::out_of_range if position exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &at(size_t position) const
+            {
+                detail::checkIteratorIndex(position, original_elements->size());
+                return (*original_elements)[position];
+            }
+
+            /**
+             * @brief Equality operator for the Order iterator.
+             * @param other Another Order iterator to compare with.
              * @returns true if both iterators point to the same index, false otherwise.
+             * @throw None
              */
-            bool operator==(const DescendingOrder &other) const
+            bool operator==(const Order &other) const
             {
                 return current_index == other.current_index;
             }
 
             /**
-             * @brief Inequality operator for the DescendingOrder iterator.
+             * @brief Inequality operator for the Order iterator.
              * 
              * @note This function uses the equality operator to determine inequality.
              * 
-             * @param other Another DescendingOrder iterator to compare with.
+             * @param other Another Order iterator to compare with.
              * @returns true if the iterators point to different indices, false otherwise.
              * @throw None
              */
-            bool operator!=(const DescendingOrder &other) const
+            bool operator!=(const Order &other) const
             {
                 return !(*this == other);
             }
 
             /**
-             * @brief Begin method for the DescendingOrder iterator.
+             * @brief Begin method for the Order iterator.
              * @param None
-             * @returns A new DescendingOrder iterator starting from the first element.
+             * @returns A new Order iterator starting from the first element.
              * @throw None
              */
-            DescendingOrder begin()
+            Order begin()
             {
-                DescendingOrder iter = *this;
+                Order iter = *this;
                 iter.current_index = 0;
                 return iter;
             }
 
             /**
-             * @brief End method for the DescendingOrder iterator.
+             * @brief End method for the Order iterator.
              * @param None
-             * @returns A new DescendingOrder iterator pointing to one past the last element.
+             * @returns A new Order iterator pointing to one past the last element.
              * @throw None
              */
-            DescendingOrder end()
+            Order end()
             {
-                DescendingOrder iter = *this;
-                iter.current_index = sorted_elements.size();
+                Order iter = *this;
+                iter.current_index = original_elements->size();
                 return iter;
             }
+
+            /**
+             * @brief Hands out the insertion order in contiguous spans.
+             * Lets vectorized consumers run over plain arrays instead of calling operator* per element.
+             * @param fn Callable invoked as fn(Span<T>) once per chunk, in traversal order.
+             * @param chunk_size Maximum number of elements per span.
+             * @returns void
+             * @throw std::invalid_argument if chunk_size is 0.
+             */
+            template <typename Function>
+            void forEachSpan(Function fn, size_t chunk_size = DEFAULT_SPAN_SIZE) const
+            {
+                detail::forEachSpanOf(original_elements->data(), original_elements->size(), chunk_size, fn);
+            }
         };
 
         /**
-         * @brief Nested SideCrossOrder Iterator Class
-         * Alternates between smallest and largest remaining elements
+         * @brief Nested MiddleOutOrder Iterator Class
+         * Starts from middle, then alternates left-right
          */
-        class SideCrossOrder
+        class MiddleOutOrder
         {
         private:
-            std::vector<T> sorted_elements;
+            std::shared_ptr<const std::vector<T>> middle_out_elements; // Shared with every copy of this iterator
             size_t current_index;
 
         public:
             /**
-             * @brief Constructor for the SideCrossOrder iterator.
+             * @brief Constructor for the MiddleOutOrder iterator.
+             * 
+             * @note if the number of elements is even, it starts from the left middle.
+             * 
              * @param container The MyContainer instance to iterate over.
-             * @returns SideCrossOrder object.
+             * @returns MiddleOutOrder object.
              * @throw None
              */
-            SideCrossOrder(const MyContainer &container) : current_index(0)
+            MiddleOutOrder(const MyContainer &container) : current_index(0)
             {
-                // First, sort all elements
-                std::vector<T> temp_sorted = container.elements;
-                std::sort(temp_sorted.begin(), temp_sorted.end());
+                MYCONTAINER_SNAPSHOT_SCOPE(container, static_cast<size_t>(OrderKind::MiddleOutOrder));
+                if (container.elements.empty())
+                {
+                    middle_out_elements = std::make_shared<const std::vector<T>>();
+                    return; // Nothing to arrange
+                }
+
+                std::vector<T> arranged;
+                arranged.reserve(container.elements.size()); // Reserve space for efficiency (allocate once)
+
+                const std::vector<T> &elements = container.elements;
+                size_t size = elements.size();
+
+                // Calculate middle index (for even numbers, choose left middle)
+                size_t middle = (size - 1) / 2;
 
-                sorted_elements.reserve(container.elements.size()); // Reserve space for efficiency (allocate once)
+                // Start with the middle element
+                arranged.push_back(elements[middle]);
 
-                // Create side-cross order: smallest, largest, second smallest, second largest, etc.
-                size_t left = 0;
-                size_t right = temp_sorted.size();
-                bool take_from_left = true;
+                // Now alternate left and right from the middle
+                size_t left = middle;
+                size_t right = middle;
+                bool go_left = true;
 
-                while (left < right)
+                while (left > 0 || right < size - 1)
                 {
-                    if (take_from_left)
+                    if (go_left && left > 0)
+                    {
+                        --left;
+                        arranged.push_back(elements[left]);
+                        go_left = false; // Switch to right
+                    }
+                    else if (!go_left && right < size - 1)
                     {
-                        sorted_elements.push_back(temp_sorted[left]);
-                        ++left;
+                        ++right;
+                        arranged.push_back(elements[right]);
+                        go_left = true; // Switch to left
                     }
                     else
                     {
-                        --right;
-                        sorted_elements.push_back(temp_sorted[right]);
+                        // If we can't go in the current direction, try the other
+                        go_left = !go_left; // Alternate direction
                     }
-                    take_from_left = !take_from_left; // Alternate between left and right
                 }
+
+                MYCONTAINER_STAT(container.statistics.recordCopy(arranged.size(), sizeof(T)));
+                middle_out_elements = std::make_shared<const std::vector<T>>(std::move(arranged));
             }
 
             /**
-             * @brief Pre-increment operator for the SideCrossOrder iterator.
+             * @brief Pre-increment operator for the MiddleOutOrder iterator.
              * @param None
-             * @returns Reference to the current SideCrossOrder object after incrementing.
+             * @returns Reference to the current MiddleOutOrder object after incrementing.
              * @throw None
              */
-            SideCrossOrder &operator++()
+            MiddleOutOrder &operator++()
             {
                 ++current_index;
                 return *this;
             }
 
             /**
-             * @brief Post-increment operator for the SideCrossOrder iterator.
+             * @brief Post-increment operator for the MiddleOutOrder iterator.
              * @param None
-             * @returns A copy of the SideCrossOrder object before incrementing.
+             * @returns A copy of the MiddleOutOrder object before incrementing.
              * @throw None
              */
-            SideCrossOrder operator++(int)
+            MiddleOutOrder operator++(int)
             {
-                SideCrossOrder temp = *this;
+                MiddleOutOrder temp = *this;
                 ++current_index;
                 return temp;
             }
 
             /**
-             * @brief Dereference operator for the SideCrossOrder iterator.
+             * @brief Dereference operator for the MiddleOutOrder iterator.
              * @param None
-             * @returns A constant reference to the current element in the side-cross order.
-             * @throw std::out_of_range if the current index exceeds the size of sorted_elements.
+             * @returns A constant reference to the current element in middle-out order.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
              */
             const T &operator*() const
             {
-                if (current_index >= sorted_elements.size())
-                {
-                    throw std::out_of_range("Iterator out of range");
-                }
-                return sorted_elements[current_index];
+                detail::checkIteratorIndex(current_index, middle_out_elements->size());
+                return (*middle_out_elements)[current_index];
             }
 
             /**
-             * @brief Equality operator for the SideCrossOrder iterator.
-             * @param other Another SideCrossOrder iterator to compare with.
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The position of end().
+             * @throw None
+             */
+            size_t size() const { return middle_out_elements->size(); }
+
+            /**
+             * @brief Returns the element at a position of the middle-out order, in O(1).
+             * @param position Position in the order, smaller than size().
+             * @returns A constant reference to the element.
+             * @throw std::out_of_range if position exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &at(size_t position) const
+            {
+                detail::checkIteratorIndex(position, middle_out_elements->size());
+                return (*middle_out_elements)[position];
+            }
+
+            /**
+             * @brief Equality operator for the MiddleOutOrder iterator.
+             * @param other Another MiddleOutOrder iterator to compare with.
              * @returns true if both iterators point to the same index, false otherwise.
              * @throw None
              */
-            bool operator==(const SideCrossOrder &other) const
+            bool operator==(const MiddleOutOrder &other) const
             {
                 return current_index == other.current_index;
             }
 
             /**
-             * @brief Inequality operator for the SideCrossOrder iterator.
+             * @brief Inequality operator for the MiddleOutOrder iterator.
              * 
              * @note This function uses the equality operator to determine inequality.
              * 
-             * @param other Another SideCrossOrder iterator to compare with.
+             * @param other Another MiddleOutOrder iterator to compare with.
              * @returns true if the iterators point to different indices, false otherwise.
              * @throw None
              */
-            bool operator!=(const SideCrossOrder &other) const
+            bool operator!=(const MiddleOutOrder &other) const
             {
                 return !(*this == other);
             }
 
             /**
-             * @brief Begin method for the SideCrossOrder iterator.
+             * @brief Begin method for the MiddleOutOrder iterator.
              * @param None
-             * @returns A new SideCrossOrder iterator starting from the first element.
+             * @returns A new MiddleOutOrder iterator starting from the first element.
              * @throw None
              */
-            SideCrossOrder begin()
+            MiddleOutOrder begin()
             {
-                SideCrossOrder iter = *this;
+                MiddleOutOrder iter = *this;
                 iter.current_index = 0;
                 return iter;
             }
 
             /**
-             * @brief End method for the SideCrossOrder iterator.
+             * @brief End method for the MiddleOutOrder iterator.
              * @param None
-             * @returns A new SideCrossOrder iterator pointing to one past the last element.
+             * @returns A new MiddleOutOrder iterator pointing to one past the last element.
              * @throw None
              */
-            SideCrossOrder end()
+            MiddleOutOrder end()
             {
-                SideCrossOrder iter = *this;
-                iter.current_index = sorted_elements.size();
+                MiddleOutOrder iter = *this;
+                iter.current_index = middle_out_elements->size();
                 return iter;
             }
+
+            /**
+             * @brief Hands out the middle-out order in contiguous spans.
+             * Lets vectorized consumers run over plain arrays instead of calling operator* per element.
+             * @param fn Callable invoked as fn(Span<T>) once per chunk, in traversal order.
+             * @param chunk_size Maximum number of elements per span.
+             * @returns void
+             * @throw std::invalid_argument if chunk_size is 0.
+             */
+            template <typename Function>
+            void forEachSpan(Function fn, size_t chunk_size = DEFAULT_SPAN_SIZE) const
+            {
+                detail::forEachSpanOf(middle_out_elements->data(), middle_out_elements->size(), chunk_size, fn);
+            }
         };
 
         /**
-         * @brief Nested ReverseOrder Iterator Class
-         * Traverses elements in reverse insertion order
+         * @brief Nested DistinctAscendingOrder Iterator Class
+         * Traverses each distinct value once, from smallest to largest
          */
-        class ReverseOrder
+        class DistinctAscendingOrder
         {
         private:
-            std::vector<T> reverse_elements;
+            std::shared_ptr<const std::vector<T>> distinct_elements; // Shared with every copy of this iterator
             size_t current_index;
 
         public:
             /**
-             * @brief Constructor for the ReverseOrder iterator.
+             * @brief Constructor for the DistinctAscendingOrder iterator.
+             * Keeps the first element of every run of equal values of the container's sort cache.
              * @param container The MyContainer instance to iterate over.
-             * @returns ReverseOrder object.
+             * @returns DistinctAscendingOrder object.
              * @throw None
              */
-            ReverseOrder(const MyContainer &container) : current_index(0)
+            DistinctAscendingOrder(const MyContainer &container) : current_index(0)
             {
-                // Copy elements in reverse order
-                reverse_elements.reserve(container.elements.size()); // Reserve space for efficiency(allicate once)
-                for (auto it = container.elements.rbegin(); it != container.elements.rend(); ++it)
+                MYCONTAINER_SNAPSHOT_SCOPE(container, ContainerStats::DISTINCT_ASCENDING);
+                std::shared_ptr<const std::vector<T>> sorted = container.sortedElements();
+                std::shared_ptr<const std::vector<size_t>> starts = container.sortedRunStarts(*sorted);
+                std::vector<T> values;
+                values.reserve(starts->size());
+                for (size_t run = 0; run < starts->size(); ++run)
                 {
-                    reverse_elements.push_back(*it);
+                    values.push_back((*sorted)[(*starts)[run]]);
                 }
+                MYCONTAINER_STAT(container.statistics.recordCopy(values.size(), sizeof(T)));
+                distinct_elements = std::make_shared<const std::vector<T>>(std::move(values));
             }
 
             /**
-             * @brief Pre-increment operator for the ReverseOrder iterator.
+             * @brief Pre-increment operator for the DistinctAscendingOrder iterator.
              * @param None
-             * @returns Reference to the current ReverseOrder object after incrementing.
+             * @returns Reference to the current DistinctAscendingOrder object after incrementing.
              * @throw None
              */
-            ReverseOrder &operator++()
+            DistinctAscendingOrder &operator++()
             {
                 ++current_index;
                 return *this;
             }
 
             /**
-             * @brief Post-increment operator for the ReverseOrder iterator.
+             * @brief Post-increment operator for the DistinctAscendingOrder iterator.
              * @param None
-             * @returns A copy of the ReverseOrder object before incrementing.
+             * @returns A copy of the DistinctAscendingOrder object before incrementing.
              * @throw None
              */
-            ReverseOrder operator++(int)
+            DistinctAscendingOrder operator++(int)
             {
-                ReverseOrder temp = *this;
+                DistinctAscendingOrder temp = *this;
                 ++current_index;
                 return temp;
             }
 
             /**
-             * @brief Dereference operator for the ReverseOrder iterator.
+             * @brief Dereference operator for the DistinctAscendingOrder iterator.
              * @param None
-             * @returns A constant reference to the current element in reverse order.
-             * @throw std::out_of_range if the current index exceeds the size of reverse_elements.
+             * @returns A constant reference to the current distinct element.
+             * @throw std::out_of_range if the current index exceeds the number of distinct elements (see MYCONTAINER_ITERATOR_CHECKS).
              */
             const T &operator*() const
             {
-                if (current_index >= reverse_elements.size())
-                {
-                    throw std::out_of_range("Iterator out of range");
-                }
-                return reverse_elements[current_index];
+                detail::checkIteratorIndex(current_index, distinct_elements->size());
+                return (*distinct_elements)[current_index];
             }
 
             /**
-             * @brief Equality operator for the ReverseOrder iterator.
-             * @param other Another ReverseOrder iterator to compare with.
+             * @brief Equality operator for the DistinctAscendingOrder iterator.
+             * @param other Another DistinctAscendingOrder iterator to compare with.
              * @returns true if both iterators point to the same index, false otherwise.
              * @throw None
              */
-            bool operator==(const ReverseOrder &other) const
+            bool operator==(const DistinctAscendingOrder &other) const
             {
                 return current_index == other.current_index;
             }
 
             /**
-             * @brief Inequality operator for the ReverseOrder iterator.
+             * @brief Inequality operator for the DistinctAscendingOrder iterator.
              * 
              * @note This function uses the equality operator to determine inequality.
              * 
-             * @param other Another ReverseOrder iterator to compare with.
+             * @param other Another DistinctAscendingOrder iterator to compare with.
              * @returns true if the iterators point to different indices, false otherwise.
              * @throw None
              */
-            bool operator!=(const ReverseOrder &other) const
+            bool operator!=(const DistinctAscendingOrder &other) const
             {
                 return !(*this == other);
             }
 
             /**
-             * @brief Begin method for the ReverseOrder iterator.
+             * @brief Begin method for the DistinctAscendingOrder iterator.
              * @param None
-             * @returns A new ReverseOrder iterator starting from the first element.
+             * @returns A new DistinctAscendingOrder iterator starting from the first element.
              * @throw None
              */
-            ReverseOrder begin()
+            DistinctAscendingOrder begin()
             {
-                ReverseOrder iter = *this;
+                DistinctAscendingOrder iter = *this;
                 iter.current_index = 0;
                 return iter;
             }
 
             /**
-             * @brief End method for the ReverseOrder iterator.
+             * @brief End method for the DistinctAscendingOrder iterator.
              * @param None
-             * @returns A new ReverseOrder iterator pointing to one past the last element.
+             * @returns A new DistinctAscendingOrder iterator pointing to one past the last element.
              * @throw None
              */
-            ReverseOrder end()
+            DistinctAscendingOrder end()
             {
-                ReverseOrder iter = *this;
-                iter.current_index = reverse_elements.size();
+                DistinctAscendingOrder iter = *this;
+                iter.current_index = distinct_elements->size();
                 return iter;
             }
         };
 
         /**
-         * @brief Nested Order Iterator Class
-         * Traverses elements in original insertion order
+         * @brief Nested GroupedAscendingOrder Iterator Class
+         * Traverses each distinct value once, from smallest to largest, together with its multiplicity
          */
-        class Order
+        class GroupedAscendingOrder
         {
         private:
-            std::vector<T> original_elements;
+            std::shared_ptr<const std::vector<ValueCount>> groups; // Shared with every copy of this iterator
             size_t current_index;
 
         public:
             /**
-             * @brief Constructor for the Order iterator.
+             * @brief Constructor for the GroupedAscendingOrder iterator.
+             * Collapses every run of equal values of the container's sort cache into one group.
              * @param container The MyContainer instance to iterate over.
-             * @returns Order object.
+             * @returns GroupedAscendingOrder object.
              * @throw None
              */
-            Order(const MyContainer &container): original_elements(container.elements), current_index(0)
+            GroupedAscendingOrder(const MyContainer &container) : current_index(0)
             {
-                // Simply copy elements in their original order - no sorting needed
+                MYCONTAINER_SNAPSHOT_SCOPE(container, ContainerStats::GROUPED_ASCENDING);
+                std::shared_ptr<const std::vector<T>> sorted = container.sortedElements();
+                std::shared_ptr<const std::vector<size_t>> starts = container.sortedRunStarts(*sorted);
+                std::vector<ValueCount> runs;
+                runs.reserve(starts->size());
+                for (size_t run = 0; run < starts->size(); ++run)
+                {
+                    size_t start = (*starts)[run];
+                    size_t stop = run + 1 < starts->size() ? (*starts)[run + 1] : sorted->size();
+                    ValueCount group = {(*sorted)[start], stop - start};
+                    runs.push_back(group);
+                }
+                MYCONTAINER_STAT(container.statistics.recordCopy(runs.size(), sizeof(T)));
+                groups = std::make_shared<const std::vector<ValueCount>>(std::move(runs));
             }
 
             /**
-             * @brief Pre-increment operator for the Order iterator.
+             * @brief Pre-increment operator for the GroupedAscendingOrder iterator.
              * @param None
-             * @returns Reference to the current Order object after incrementing.
+             * @returns Reference to the current GroupedAscendingOrder object after incrementing.
              * @throw None
              */
-            Order &operator++()
+            GroupedAscendingOrder &operator++()
             {
                 ++current_index;
                 return *this;
             }
 
             /**
-             * @brief Post-increment operator for the Order iterator.
+             * @brief Post-increment operator for the GroupedAscendingOrder iterator.
              * @param None
-             * @returns A copy of the Order object before incrementing.
+             * @returns A copy of the GroupedAscendingOrder object before incrementing.
              * @throw None
              */
-            Order operator++(int)
+            GroupedAscendingOrder operator++(int)
             {
-                Order temp = *this;
+                GroupedAscendingOrder temp = *this;
                 ++current_index;
                 return temp;
             }
 
             /**
-             * @brief Dereference operator for the Order iterator.
+             * @brief Dereference operator for the GroupedAscendingOrder iterator.
              * @param None
-             * @returns A constant reference to the current element in original order.
-             * @throw std::out_of_range if the current index exceeds the size of original_elements.
+             * @returns A constant reference to the current value and its number of occurrences.
+             * @throw std::out_of_range if the current index exceeds the number of groups (see MYCONTAINER_ITERATOR_CHECKS).
              */
-            const T &operator*() const
+            const ValueCount &operator*() const
             {
-                if (current_index >= original_elements.size())
-                {
-                    throw std::out_of_range("Iterator out of range");
-                }
-                return original_elements[current_index];
+                detail::checkIteratorIndex(current_index, groups->size());
+                return (*groups)[current_index];
             }
 
             /**
-             * @brief Equality operator for the Order iterator.
-             * @param other Another Order iterator to compare with.
+             * @brief Equality operator for the GroupedAscendingOrder iterator.
+             * @param other Another GroupedAscendingOrder iterator to compare with.
              * @returns true if both iterators point to the same index, false otherwise.
              * @throw None
              */
-            bool operator==(const Order &other) const
+            bool operator==(const GroupedAscendingOrder &other) const
             {
                 return current_index == other.current_index;
             }
 
             /**
-             * @brief Inequality operator for the Order iterator.
+             * @brief Inequality operator for the GroupedAscendingOrder iterator.
              * 
              * @note This function uses the equality operator to determine inequality.
              * 
-             * @param other Another Order iterator to compare with.
+             * @param other Another GroupedAscendingOrder iterator to compare with.
              * @returns true if the iterators point to different indices, false otherwise.
              * @throw None
              */
-            bool operator!=(const Order &other) const
+            bool operator!=(const GroupedAscendingOrder &other) const
             {
                 return !(*this == other);
             }
 
             /**
-             * @brief Begin method for the Order iterator.
+             * @brief Begin method for the GroupedAscendingOrder iterator.
              * @param None
-             * @returns A new Order iterator starting from the first element.
+             * @returns A new GroupedAscendingOrder iterator starting from the first element.
              * @throw None
              */
-            Order begin()
+            GroupedAscendingOrder begin()
             {
-                Order iter = *this;
+                GroupedAscendingOrder iter = *this;
                 iter.current_index = 0;
                 return iter;
             }
 
             /**
-             * @brief End method for the Order iterator.
+             * @brief End method for the GroupedAscendingOrder iterator.
              * @param None
-             * @returns A new Order iterator pointing to one past the last element.
+             * @returns A new GroupedAscendingOrder iterator pointing to one past the last element.
              * @throw None
              */
-            Order end()
+            GroupedAscendingOrder end()
             {
-                Order iter = *this;
-                iter.current_index = original_elements.size();
+                GroupedAscendingOrder iter = *this;
+                iter.current_index = groups->size();
                 return iter;
             }
         };
 
         /**
-         * @brief Nested MiddleOutOrder Iterator Class
-         * Starts from middle, then alternates left-right
+         * @brief Nested Generator Class
+         * Produces any of the six orders one element at a time, doing only the work for the elements requested,
+         * so a consumer that stops after k elements never pays for the full snapshot or sort (see generate()).
+         * Order, ReverseOrder and MiddleOutOrder map each position to an index of the elements in O(1);
+         * the sorted orders pop a heap copy of the elements (O(n) to build, O(log n) per element), SideCrossOrder
+         * from two heaps, one per side. With a warm sort cache the sorted orders read it through cursors instead,
+         * and a consumer that reads past 1/16 of a sorted order switches to the sort cache (sorting once), so
+         * full traversals cost about as much as with the eager iterators.
+         *
+         * @note Single pass: every copy of the generator shares one read position, so the order can be traversed
+         * once and begin() returns the current position. The elements are read in place, so the container must
+         * not be modified while the generator is in use.
          */
-        class MiddleOutOrder
+        class Generator
         {
         private:
-            std::vector<T> middle_out_elements;
-            size_t current_index;
-
-        public:
-            /**
-             * @brief Constructor for the MiddleOutOrder iterator.
-             * 
-             * @note if the number of elements is even, it starts from the left middle.
-             * 
-             * @param container The MyContainer instance to iterate over.
-             * @returns MiddleOutOrder object.
-             * @throw None
+            // Heap orderings that only need operator<: the front is the smallest (Min) or largest (Max) element
+            struct MinHeapCompare
+            {
+                bool operator()(const T &a, const T &b) const { return b < a; }
+            };
+            struct MaxHeapCompare
+            {
+                bool operator()(const T &a, const T &b) const { return a < b; }
+            };
+
+            /**
+             * @brief Producer shared by the copies of one generator.
              */
-            MiddleOutOrder(const MyContainer &container) : current_index(0)
+            class State
             {
-                if (container.elements.empty())
+            private:
+                OrderKind kind;
+                const MyContainer *container;
+                const std::vector<T> *elements;                 // The container's elements, read in place
+                std::shared_ptr<const std::vector<T>> sorted;   // The sort cache once warm or switched to, else null
+                std::vector<T> small_heap;                      // Not produced yet, smallest at the front
+                std::vector<T> large_heap;                      // Not produced yet, largest at the front
+                bool small_built;
+                bool large_built;
+                const T *current_element;
+                size_t position;
+
+                /**
+                 * @brief Pops the next element of one side off its heap, building the heap on first use.
+                 * The popped element stays at the back of the heap vector until the next pop, so current()
+                 * can refer to it.
+                 * @param heap The heap of the side.
+                 * @param built Whether the heap was built.
+                 * @param compare Heap ordering of the side.
+                 * @returns The popped element.
+                 * @throw Whatever T's operator< throws.
+                 */
+                template <typename HeapCompare>
+                const T *popNext(std::vector<T> &heap, bool &built, HeapCompare compare)
                 {
-                    return; // Nothing to arrange
+                    if (!built)
+                    {
+                        MYCONTAINER_TRACE_SCOPE("heapify", elements->size());
+                        heap = *elements;
+                        std::make_heap(heap.begin(), heap.end(), compare);
+                        built = true;
+                    }
+                    else
+                    {
+                        heap.pop_back(); // The element produced by the previous pop
+                    }
+                    std::pop_heap(heap.begin(), heap.end(), compare);
+                    return &heap.back();
                 }
 
-                middle_out_elements.reserve(container.elements.size()); // Reserve space for efficiency (allocate once)
-
-                const std::vector<T> &elements = container.elements;
-                size_t size = elements.size();
-
-                // Calculate middle index (for even numbers, choose left middle)
-                size_t middle = (size - 1) / 2;
-
-                // Start with the middle element
-                middle_out_elements.push_back(elements[middle]);
-
-                // Now alternate left and right from the middle
-                size_t left = middle;
-                size_t right = middle;
-                bool go_left = true;
-
-                while (left > 0 || right < size - 1)
+                /**
+                 * @brief Reads the rest of a sorted order from the sort cache once the consumer went past 1/16
+                 * of it: from there on one sort is cheaper than popping the heaps.
+                 * @param None
+                 * @returns void
+                 * @throw Whatever T's operator< throws.
+                 */
+                void switchToSortCache()
                 {
-                    if (go_left && left > 0)
+                    if (sorted || position < SWITCH_MINIMUM || position < elements->size() / 16)
                     {
-                        --left;
-                        middle_out_elements.push_back(elements[left]);
-                        go_left = false; // Switch to right
+                        return;
                     }
-                    else if (!go_left && right < size - 1)
+                    sorted = container->sortedElements();
+                    std::vector<T>().swap(small_heap);
+                    std::vector<T>().swap(large_heap);
+                }
+
+                /**
+                 * @brief Produces the element at the current position.
+                 * @param None
+                 * @returns void
+                 * @throw Whatever T's operator< throws.
+                 */
+                void produce()
+                {
+                    const size_t count = elements->size();
+                    if (position >= count)
                     {
-                        ++right;
-                        middle_out_elements.push_back(elements[right]);
-                        go_left = true; // Switch to left
+                        current_element = NULL;
+                        return;
                     }
-                    else
+                    switch (kind)
                     {
-                        // If we can't go in the current direction, try the other
-                        go_left = !go_left; // Alternate direction
+                    case OrderKind::Order:
+                        current_element = &(*elements)[position];
+                        break;
+                    case OrderKind::ReverseOrder:
+                        current_element = &(*elements)[count - 1 - position];
+                        break;
+                    case OrderKind::MiddleOutOrder:
+                        current_element = &(*elements)[detail::middleOutIndex(position, count)];
+                        break;
+                    case OrderKind::AscendingOrder:
+                        switchToSortCache();
+                        current_element = sorted ? &(*sorted)[position] : popNext(small_heap, small_built, MinHeapCompare());
+                        break;
+                    case OrderKind::DescendingOrder:
+                        switchToSortCache();
+                        current_element = sorted ? &(*sorted)[count - 1 - position] : popNext(large_heap, large_built, MaxHeapCompare());
+                        break;
+                    case OrderKind::SideCrossOrder:
+                        switchToSortCache();
+                        if (sorted)
+                        {
+                            current_element = &(*sorted)[detail::sideCrossIndex(position, count)];
+                        }
+                        else if (position % 2 == 0) // Even positions take the next smallest, odd ones the next largest
+                        {
+                            current_element = popNext(small_heap, small_built, MinHeapCompare());
+                        }
+                        else
+                        {
+                            current_element = popNext(large_heap, large_built, MaxHeapCompare());
+                        }
+                        break;
                     }
                 }
+
+            public:
+                // Positions read from the heaps before a sorted order may switch to the sort cache
+                static const size_t SWITCH_MINIMUM = 64;
+
+                State(OrderKind order_kind, const MyContainer &source, std::shared_ptr<const std::vector<T>> sort_cache)
+                    : kind(order_kind), container(&source), elements(&source.elements), sorted(sort_cache),
+                      small_built(false), large_built(false), current_element(NULL), position(0)
+                {
+                    produce();
+                }
+
+                const T &current() const { return *current_element; }
+
+                void advance()
+                {
+                    ++position;
+                    produce();
+                }
+
+                size_t index() const { return position; }
+
+                size_t size() const { return elements->size(); }
+            };
+
+            std::shared_ptr<State> state; // Shared with every copy of this generator
+            size_t current_index;
+
+        public:
+            /**
+             * @brief Constructor for the Generator.
+             * Produces the first element; nothing is copied or sorted for the index-mapped orders.
+             * @param container The MyContainer instance to traverse.
+             * @param kind The order to produce.
+             * @returns Generator object.
+             * @throw Whatever T's operator< throws.
+             */
+            Generator(const MyContainer &container, OrderKind kind) : current_index(0)
+            {
+                bool sorted_kind = kind == OrderKind::AscendingOrder || kind == OrderKind::DescendingOrder || kind == OrderKind::SideCrossOrder;
+                state = std::make_shared<State>(kind, container,
+                                                sorted_kind ? container.sort_cache.load() : std::shared_ptr<const std::vector<T>>());
             }
 
             /**
-             * @brief Pre-increment operator for the MiddleOutOrder iterator.
+             * @brief Pre-increment operator for the Generator.
              * @param None
-             * @returns Reference to the current MiddleOutOrder object after incrementing.
-             * @throw None
+             * @returns Reference to the current Generator object after producing the next element.
+             * @throw Whatever T's operator< throws.
              */
-            MiddleOutOrder &operator++()
+            Generator &operator++()
             {
+                if (state->index() < state->size())
+                {
+                    state->advance();
+                }
                 ++current_index;
                 return *this;
             }
 
             /**
-             * @brief Post-increment operator for the MiddleOutOrder iterator.
+             * @brief Post-increment operator for the Generator.
+             *
+             * @note The returned copy shares the read position, dereferencing it yields the new current element.
+             *
              * @param None
-             * @returns A copy of the MiddleOutOrder object before incrementing.
-             * @throw None
+             * @returns A copy of the Generator object before incrementing.
+             * @throw Whatever T's operator< throws.
              */
-            MiddleOutOrder operator++(int)
+            Generator operator++(int)
             {
-                MiddleOutOrder temp = *this;
-                ++current_index;
+                Generator temp = *this;
+                ++*this;
                 return temp;
             }
 
             /**
-             * @brief Dereference operator for the MiddleOutOrder iterator.
+             * @brief Dereference operator for the Generator.
              * @param None
-             * @returns A constant reference to the current element in middle-out order.
-             * @throw std::out_of_range if the current index exceeds the size of middle_out_elements.
+             * @returns A constant reference to the current element, valid until the generator advances.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
              */
             const T &operator*() const
             {
-                if (current_index >= middle_out_elements.size())
-                {
-                    throw std::out_of_range("Iterator out of range");
-                }
-                return middle_out_elements[current_index];
+                detail::checkIteratorIndex(state->index(), state->size()); // The shared position, not this copy's
+                return state->current();
             }
 
             /**
-             * @brief Equality operator for the MiddleOutOrder iterator.
-             * @param other Another MiddleOutOrder iterator to compare with.
-             * @returns true if both iterators point to the same index, false otherwise.
+             * @brief Equality operator for the Generator.
+             * @param other Another Generator to compare with.
+             * @returns true if both generators point to the same index, false otherwise.
              * @throw None
              */
-            bool operator==(const MiddleOutOrder &other) const
+            bool operator==(const Generator &other) const
             {
                 return current_index == other.current_index;
             }
 
             /**
-             * @brief Inequality operator for the MiddleOutOrder iterator.
-             * 
-             * @note This function uses the equality operator to determine inequality.
-             * 
-             * @param other Another MiddleOutOrder iterator to compare with.
-             * @returns true if the iterators point to different indices, false otherwise.
+             * @brief Inequality operator for the Generator.
+             * @param other Another Generator to compare with.
+             * @returns true if the generators point to different indices, false otherwise.
              * @throw None
              */
-            bool operator!=(const MiddleOutOrder &other) const
+            bool operator!=(const Generator &other) const
             {
                 return !(*this == other);
             }
 
             /**
-             * @brief Begin method for the MiddleOutOrder iterator.
+             * @brief Begin method for the Generator.
              * @param None
-             * @returns A new MiddleOutOrder iterator starting from the first element.
+             * @returns A copy of this generator (the order is single pass and cannot be rewound).
              * @throw None
              */
-            MiddleOutOrder begin()
+            Generator begin()
             {
-                MiddleOutOrder iter = *this;
-                iter.current_index = 0;
-                return iter;
+                return *this;
             }
 
             /**
-             * @brief End method for the MiddleOutOrder iterator.
+             * @brief End method for the Generator.
              * @param None
-             * @returns A new MiddleOutOrder iterator pointing to one past the last element.
+             * @returns A new Generator pointing to one past the last element.
              * @throw None
              */
-            MiddleOutOrder end()
+            Generator end()
             {
-                MiddleOutOrder iter = *this;
-                iter.current_index = middle_out_elements.size();
+                Generator iter = *this;
+                iter.current_index = state->size();
                 return iter;
             }
         };
 
+        typedef my_cont_ns::ExternalSortedOrder<T, std::less<T>> ExternalAscendingOrder;
+        typedef my_cont_ns::ExternalSortedOrder<T, std::greater<T>> ExternalDescendingOrder;
+
         // Factory methods to create iterators:
         AscendingOrder getAscendingOrder() const { return AscendingOrder(*this); }
 
         DescendingOrder getDescendingOrder() const { return DescendingOrder(*this); }
 
+        /**
+         * @brief Lazy variants of the sorted iterators.
+         * The elements are heapified in O(n) and one element is popped per new position,
+         * so reading only the first k elements costs O(n + k log n) instead of a full sort.
+         */
+        AscendingOrder getLazyAscendingOrder() const { return AscendingOrder(*this, true); }
+
+        DescendingOrder getLazyDescendingOrder() const { return DescendingOrder(*this, true); }
+
+        /**
+         * @brief Duplicate-collapsing variants of the ascending iterator.
+         * getDistinctAscending() yields every distinct value once,
+         * getGroupedAscending() also yields how many times each value occurs.
+         */
+        DistinctAscendingOrder getDistinctAscending() const { return DistinctAscendingOrder(*this); }
+
+        GroupedAscendingOrder getGroupedAscending() const { return GroupedAscendingOrder(*this); }
+
+        /**
+         * @brief External-memory variants of the sorted iterators, for containers whose sorted copy does not fit in memory.
+         * At most memory_budget bytes of element buffers are used; the rest of the order lives in temporary files
+         * under temp_directory ($TMPDIR or /tmp when empty) that are deleted automatically.
+         */
+        ExternalAscendingOrder getExternalAscendingOrder(size_t memory_budget, const std::string &temp_directory = "") const
+        {
+            return ExternalAscendingOrder(elements.data(), elements.size(), memory_budget, temp_directory);
+        }
+
+        ExternalDescendingOrder getExternalDescendingOrder(size_t memory_budget, const std::string &temp_directory = "") const
+        {
+            return ExternalDescendingOrder(elements.data(), elements.size(), memory_budget, temp_directory);
+        }
+
         SideCrossOrder getSideCrossOrder() const { return SideCrossOrder(*this); }
 
         ReverseOrder getReverseOrder() const { return ReverseOrder(*this); }
@@ -890,8 +2886,317 @@ namespace my_cont_ns
         Order getOrder() const { return Order(*this); }
 
         MiddleOutOrder getMiddleOutOrder() const { return MiddleOutOrder(*this); }
+
+        /**
+         * @brief Lazy, single-pass generator of any of the six orders (see Generator).
+         * Only the elements actually read are produced, so stopping early skips the rest of the sort or snapshot.
+         */
+        Generator generate(OrderKind kind) const { return Generator(*this, kind); }
+
+        /**
+         * @brief Asynchronous variants of the iterator factories.
+         * The iterator (sort, snapshot or arrangement) is built on ThreadPool::instance() and handed out through
+         * the future, so the caller can overlap the build with other work; future.get() rethrows what the
+         * build threw. A pool without workers builds it before the call returns.
+         *
+         * @note The container is read when the task runs: it must outlive the task and must not be modified
+         * until the future is ready. Waiting for the future inside a pool task may deadlock the pool.
+         */
+        std::future<AscendingOrder> getAscendingOrderAsync() const
+        {
+            const MyContainer *self = this;
+            return buildAsync<AscendingOrder>([self]()
+                                              { return self->getAscendingOrder(); });
+        }
+
+        std::future<DescendingOrder> getDescendingOrderAsync() const
+        {
+            const MyContainer *self = this;
+            return buildAsync<DescendingOrder>([self]()
+                                               { return self->getDescendingOrder(); });
+        }
+
+        std::future<SideCrossOrder> getSideCrossOrderAsync() const
+        {
+            const MyContainer *self = this;
+            return buildAsync<SideCrossOrder>([self]()
+                                              { return self->getSideCrossOrder(); });
+        }
+
+        std::future<ReverseOrder> getReverseOrderAsync() const
+        {
+            const MyContainer *self = this;
+            return buildAsync<ReverseOrder>([self]()
+                                            { return self->getReverseOrder(); });
+        }
+
+        std::future<Order> getOrderAsync() const
+        {
+            const MyContainer *self = this;
+            return buildAsync<Order>([self]()
+                                     { return self->getOrder(); });
+        }
+
+        std::future<MiddleOutOrder> getMiddleOutOrderAsync() const
+        {
+            const MyContainer *self = this;
+            return buildAsync<MiddleOutOrder>([self]()
+                                              { return self->getMiddleOutOrder(); });
+        }
+    };
+
+    /**
+     * @brief MergedOrder Iterator Class
+     * Traverses the elements of several containers as one sorted stream (see mergeAscending() and mergeDescending()).
+     * Every container contributes its sort cache, and a loser tree over the k current heads yields the next
+     * element with O(log k) comparisons, so the containers are neither concatenated nor sorted again.
+     *
+     * @note The iterator keeps one read position per container, so copying it costs O(k).
+     * Like the other iterators it works on a snapshot: later changes to the containers are not seen.
+     */
+    template <typename T, typename Compare>
+    class MergedOrder
+    {
+    private:
+        std::vector<std::shared_ptr<const std::vector<T>>> sources; // Ascending elements of every container
+        bool reversed;                                              // Read every source from its back
+        std::vector<size_t> consumed;                               // Elements taken from each source
+        std::vector<size_t> tree;                                   // tree[0] is the winner, tree[1..k-1] the losers
+        size_t total;
+        size_t current_index;
+
+        /**
+         * @brief Returns the current head of a source.
+         * @param source Index of a source that is not exhausted.
+         * @returns A constant reference to the head.
+         * @throw None
+         */
+        const T &head(size_t source) const
+        {
+            const std::vector<T> &sorted = *sources[source];
+            return reversed ? sorted[sorted.size() - 1 - consumed[source]] : sorted[consumed[source]];
+        }
+
+        /**
+         * @brief Checks if a source comes before another one in the merge.
+         * Exhausted sources lose against everything; equal heads go to the lower source index.
+         * @param a Index of a source.
+         * @param b Index of another source.
+         * @returns true if a wins.
+         * @throw None
+         */
+        bool beats(size_t a, size_t b) const
+        {
+            if (consumed[b] == sources[b]->size())
+            {
+                return true;
+            }
+            if (consumed[a] == sources[a]->size())
+            {
+                return false;
+            }
+            const T &head_a = head(a);
+            const T &head_b = head(b);
+            return Compare()(head_a, head_b) || (!Compare()(head_b, head_a) && a < b);
+        }
+
+        /**
+         * @brief Resets every source to its first element and plays the initial tournament in O(k).
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void rebuild()
+        {
+            const size_t k = sources.size();
+            consumed.assign(k, 0);
+            tree.assign(std::max<size_t>(k, 1), 0);
+            std::vector<size_t> winners(2 * k);
+            for (size_t source = 0; source < k; ++source)
+            {
+                winners[k + source] = source; // Leaves
+            }
+            for (size_t node = k - 1; node >= 1 && k > 1; --node)
+            {
+                size_t a = winners[2 * node];
+                size_t b = winners[2 * node + 1];
+                bool a_wins = beats(a, b);
+                winners[node] = a_wins ? a : b;
+                tree[node] = a_wins ? b : a;
+            }
+            tree[0] = k > 1 ? winners[1] : 0;
+        }
+
+    public:
+        /**
+         * @brief Constructor for the MergedOrder iterator.
+         * @param containers The containers to merge (the pointers must not be null).
+         * @param reverse true to merge from largest to smallest.
+         * @returns MergedOrder object.
+         * @throw std::invalid_argument if a container pointer is null.
+         */
+        MergedOrder(const std::vector<const MyContainer<T> *> &containers, bool reverse)
+            : reversed(reverse), total(0), current_index(0)
+        {
+            for (size_t i = 0; i < containers.size(); ++i)
+            {
+                if (containers[i] == NULL)
+                {
+                    throw std::invalid_argument("Cannot merge a null container");
+                }
+                sources.push_back(containers[i]->sortedElements());
+                total += sources.back()->size();
+            }
+            rebuild();
+        }
+
+        /**
+         * @brief Returns the number of elements in the merged order.
+         * @param None
+         * @returns The total size of the merged containers.
+         * @throw None
+         */
+        size_t size() const { return total; }
+
+        /**
+         * @brief Pre-increment operator for the MergedOrder iterator.
+         * Replays the winner's path from its leaf to the root, O(log k) comparisons.
+         * @param None
+         * @returns Reference to the current MergedOrder object after incrementing.
+         * @throw None
+         */
+        MergedOrder &operator++()
+        {
+            ++current_index;
+            if (current_index > total)
+            {
+                return *this; // Already past the end
+            }
+            size_t winner = tree[0];
+            ++consumed[winner];
+            const size_t k = sources.size();
+            for (size_t node = (winner + k) / 2; node >= 1; node /= 2)
+            {
+                if (beats(tree[node], winner))
+                {
+                    std::swap(tree[node], winner);
+                }
+            }
+            tree[0] = winner;
+            return *this;
+        }
+
+        /**
+         * @brief Post-increment operator for the MergedOrder iterator.
+         * @param None
+         * @returns A copy of the MergedOrder object before incrementing.
+         * @throw None
+         */
+        MergedOrder operator++(int)
+        {
+            MergedOrder temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        /**
+         * @brief Dereference operator for the MergedOrder iterator.
+         * @param None
+         * @returns A constant reference to the current element of the merged order.
+         * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+         */
+        const T &operator*() const
+        {
+            detail::checkIteratorIndex(current_index, total);
+            return head(tree[0]);
+        }
+
+        /**
+         * @brief Equality operator for the MergedOrder iterator.
+         * @param other Another MergedOrder iterator to compare with.
+         * @returns true if both iterators point to the same index, false otherwise.
+         * @throw None
+         */
+        bool operator==(const MergedOrder &other) const
+        {
+            return current_index == other.current_index;
+        }
+
+        /**
+         * @brief Inequality operator for the MergedOrder iterator.
+         * @param other Another MergedOrder iterator to compare with.
+         * @returns true if the iterators point to different indices, false otherwise.
+         * @throw None
+         */
+        bool operator!=(const MergedOrder &other) const
+        {
+            return !(*this == other);
+        }
+
+        /**
+         * @brief Begin method for the MergedOrder iterator.
+         * @param None
+         * @returns A new MergedOrder iterator starting from the first element.
+         * @throw None
+         */
+        MergedOrder begin() const
+        {
+            MergedOrder iter = *this;
+            iter.current_index = 0;
+            iter.rebuild();
+            return iter;
+        }
+
+        /**
+         * @brief End method for the MergedOrder iterator.
+         * @param None
+         * @returns A new MergedOrder iterator pointing to one past the last element.
+         * @throw None
+         */
+        MergedOrder end() const
+        {
+            MergedOrder iter = *this;
+            iter.current_index = total;
+            return iter;
+        }
     };
 
+    /**
+     * @brief Merges the ascending orders of several containers into one ascending stream, without copying them.
+     * @param containers The containers, e.g. mergeAscending({&shard1, &shard2}).
+     * @returns A lazy MergedOrder iterator.
+     * @throw std::invalid_argument if a container pointer is null.
+     */
+    template <typename T>
+    MergedOrder<T, std::less<T>> mergeAscending(const std::vector<const MyContainer<T> *> &containers)
+    {
+        return MergedOrder<T, std::less<T>>(containers, false);
+    }
+
+    template <typename T>
+    MergedOrder<T, std::less<T>> mergeAscending(std::initializer_list<const MyContainer<T> *> containers)
+    {
+        return mergeAscending(std::vector<const MyContainer<T> *>(containers));
+    }
+
+    /**
+     * @brief Merges the descending orders of several containers into one descending stream, without copying them.
+     * @param containers The containers, e.g. mergeDescending({&shard1, &shard2}).
+     * @returns A lazy MergedOrder iterator.
+     * @throw std::invalid_argument if a container pointer is null.
+     */
+    template <typename T>
+    MergedOrder<T, std::greater<T>> mergeDescending(const std::vector<const MyContainer<T> *> &containers)
+    {
+        return MergedOrder<T, std::greater<T>>(containers, true);
+    }
+
+    template <typename T>
+    MergedOrder<T, std::greater<T>> mergeDescending(std::initializer_list<const MyContainer<T> *> containers)
+    {
+        return mergeDescending(std::vector<const MyContainer<T> *>(containers));
+    }
+
     /**
      * @brief Stream output operator for MyContainer
      * Allows printing container contents using operator<<
@@ -903,11 +3208,7 @@ namespace my_cont_ns
     template <typename T>
     std::ostream &operator<<(std::ostream &os, const MyContainer<T> &container)
     {
-        const auto &elements = container.getElements();
-        for (const auto &elem : elements)
-        {
-            os << elem << " ";
-        }
+        container.writeTo(os);
         return os;
     }
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <chrono>             // for std::chrono::steady_clock, std::chrono::milliseconds
+#include <condition_variable> // for std::condition_variable
+#include <cstdint>            // for uint64_t
+#include <functional>         // for std::function
+#include <memory>             // for std::unique_ptr
+#include <mutex>              // for std::mutex, std::unique_lock
+#include <thread>             // for std::thread
+
+namespace my_cont_ns
+{
+    // Default quiet period after the last mutation before a background sort starts
+    static const std::chrono::milliseconds DEFAULT_SORT_DEBOUNCE(5);
+
+    namespace detail
+    {
+        /**
+         * @brief Debounced background worker that rebuilds a container's sort cache after mutations.
+         * Every mutation holds the worker's lock while it changes the elements (see Mutation) and bumps a
+         * generation number; schedule() pushes the rebuild deadline back, so a burst of mutations costs one
+         * rebuild, started once no mutation arrived for the debounce period.
+         * The rebuild job runs on the worker thread with the lock held and releases it while it sorts; it must
+         * only publish its result if generation() is still the one it started from.
+         *
+         * @note Copies start without a worker. Assigning to, moving from or destroying an object stops its worker
+         * first, so that the job never reads elements that are being replaced.
+         */
+        class BackgroundSort
+        {
+        public:
+            typedef std::function<void(std::unique_lock<std::mutex> &)> Job;
+
+        private:
+            struct State
+            {
+                std::mutex lock; // Held by mutations, and by the job except while it sorts
+                std::condition_variable wake;
+                std::chrono::milliseconds debounce;
+                std::chrono::steady_clock::time_point deadline;
+                uint64_t generation;
+                bool scheduled;
+                bool running;
+                bool stopping;
+                Job job;
+                std::thread worker;
+            };
+
+            std::unique_ptr<State> state; // Null while background sorting is off
+
+            /**
+             * @brief Main loop of the worker thread.
+             * @param current The worker's state.
+             * @returns void
+             * @throw None
+             */
+            static void workerLoop(State *current)
+            {
+                std::unique_lock<std::mutex> guard(current->lock);
+                while (true)
+                {
+                    current->wake.wait(guard, [current]()
+                                       { return current->stopping || current->scheduled; });
+                    // Debounce: wait until no mutation moved the deadline for a whole period
+                    while (!current->stopping && current->scheduled && std::chrono::steady_clock::now() < current->deadline)
+                    {
+                        current->wake.wait_until(guard, current->deadline);
+                    }
+                    if (current->stopping)
+                    {
+                        return;
+                    }
+                    current->scheduled = false;
+                    current->running = true;
+                    try
+                    {
+                        current->job(guard);
+                    }
+                    catch (...)
+                    {
+                        // The rebuild is an optimization: a reader that finds no cache sorts by itself
+                    }
+                    if (!guard.owns_lock())
+                    {
+                        guard.lock();
+                    }
+                    current->running = false;
+                    current->wake.notify_all();
+                }
+            }
+
+        public:
+            /**
+             * @brief Scoped lock of one mutation.
+             * Holds the worker's lock (if background sorting is on) and bumps the generation, so that a rebuild
+             * that copied the elements before the mutation does not publish its result.
+             */
+            class Mutation
+            {
+            private:
+                std::unique_lock<std::mutex> guard;
+
+            public:
+                explicit Mutation(BackgroundSort &background)
+                {
+                    if (background.state)
+                    {
+                        guard = std::unique_lock<std::mutex>(background.state->lock);
+                        ++background.state->generation;
+                    }
+                }
+            };
+
+            BackgroundSort() {}
+
+            BackgroundSort(const BackgroundSort &) {}
+
+            BackgroundSort(BackgroundSort &&other) { other.stop(); }
+
+            BackgroundSort &operator=(const BackgroundSort &)
+            {
+                stop();
+                return *this;
+            }
+
+            BackgroundSort &operator=(BackgroundSort &&other)
+            {
+                stop();
+                other.stop();
+                return *this;
+            }
+
+            ~BackgroundSort() { stop(); }
+
+            /**
+             * @brief Starts the worker thread, replacing a running one.
+             * @param debounce Quiet period after the last mutation before the job runs.
+             * @param job Rebuild job, called on the worker thread with the lock held.
+             * @returns void
+             * @throw std::system_error if the thread cannot be started.
+             */
+            void start(std::chrono::milliseconds debounce, Job job)
+            {
+                stop();
+                std::unique_ptr<State> created(new State());
+                created->debounce = debounce;
+                created->generation = 0;
+                created->scheduled = false;
+                created->running = false;
+                created->stopping = false;
+                created->job = job;
+                created->worker = std::thread(&BackgroundSort::workerLoop, created.get());
+                state.swap(created);
+            }
+
+            /**
+             * @brief Stops and joins the worker thread; a rebuild in progress finishes first.
+             * @param None
+             * @returns void
+             * @throw None
+             */
+            void stop()
+            {
+                if (!state)
+                {
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> guard(state->lock);
+                    state->stopping = true;
+                }
+                state->wake.notify_all();
+                state->worker.join();
+                state.reset();
+            }
+
+            /**
+             * @brief Checks if the worker is running.
+             * @param None
+             * @returns true between start() and stop().
+             * @throw None
+             */
+            bool enabled() const { return static_cast<bool>(state); }
+
+            /**
+             * @brief Returns the mutation count, to be read with the lock held.
+             * @param None
+             * @returns The number of Mutation scopes since start().
+             * @throw None
+             */
+            uint64_t generation() const { return state->generation; }
+
+            /**
+             * @brief (Re)starts the debounce period of a rebuild; call inside a Mutation scope.
+             * @param None
+             * @returns void
+             * @throw None
+             */
+            void schedule()
+            {
+                if (!state)
+                {
+                    return;
+                }
+                state->scheduled = true;
+                state->deadline = std::chrono::steady_clock::now() + state->debounce;
+                state->wake.notify_all();
+            }
+
+            /**
+             * @brief Blocks until no rebuild is scheduled or running.
+             * @param None
+             * @returns void
+             * @throw None
+             */
+            void waitIdle() const
+            {
+                if (!state)
+                {
+                    return;
+                }
+                std::unique_lock<std::mutex> guard(state->lock);
+                State *current = state.get();
+                current->wake.wait(guard, [current]()
+                                   { return !current->scheduled && !current->running; });
+            }
+        };
+    }
+}
@@ -0,0 +1,476 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <algorithm>   // for std::sort, std::push_heap, std::pop_heap
+#include <cerrno>      // for errno
+#include <cstddef>     // for size_t
+#include <cstdlib>     // for std::getenv, mkstemp
+#include <memory>      // for std::shared_ptr
+#include <stdexcept>   // for std::runtime_error, std::invalid_argument
+#include <string>      // for std::string
+#include <type_traits> // for std::is_trivially_copyable
+#include <vector>      // for std::vector
+#include <unistd.h>    // for ::write, ::pread, ::close, ::unlink
+
+namespace my_cont_ns
+{
+    namespace detail
+    {
+        /**
+         * @brief Anonymous temporary file that holds the sorted runs of one pass of an external sort.
+         * The file is unlinked as soon as it is created, so it disappears when the object is destroyed
+         * (or the process dies) and never has to be cleaned up.
+         */
+        class SpillFile
+        {
+        private:
+            int fd;
+            size_t length; // Bytes written so far
+
+            SpillFile(const SpillFile &);
+            SpillFile &operator=(const SpillFile &);
+
+        public:
+            /**
+             * @brief Creates an empty spill file.
+             * @param directory Directory for the file; empty to use $TMPDIR, or /tmp if it is not set.
+             * @returns SpillFile object.
+             * @throw std::runtime_error if the file cannot be created.
+             */
+            explicit SpillFile(const std::string &directory) : fd(-1), length(0)
+            {
+                std::string base = directory;
+                if (base.empty())
+                {
+                    const char *tmpdir = std::getenv("TMPDIR");
+                    base = (tmpdir != NULL && *tmpdir != '\0') ? tmpdir : "/tmp";
+                }
+                std::string path = base + "/mycontainer_spill_XXXXXX";
+                std::vector<char> name(path.begin(), path.end());
+                name.push_back('\0');
+                fd = ::mkstemp(name.data());
+                if (fd < 0)
+                {
+                    throw std::runtime_error("Cannot create spill file in: " + base);
+                }
+                ::unlink(name.data());
+            }
+
+            /**
+             * @brief Destructor, closes (and thereby deletes) the file.
+             * @param None
+             * @returns None
+             * @throw None
+             */
+            ~SpillFile()
+            {
+                ::close(fd);
+            }
+
+            /**
+             * @brief Appends bytes to the end of the file.
+             * @param data The bytes.
+             * @param bytes Number of bytes.
+             * @returns void
+             * @throw std::runtime_error if the write fails (e.g. the disk is full).
+             */
+            void append(const void *data, size_t bytes)
+            {
+                const char *cursor = static_cast<const char *>(data);
+                while (bytes != 0)
+                {
+                    ssize_t written = ::write(fd, cursor, bytes);
+                    if (written < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        throw std::runtime_error("Cannot write spill file");
+                    }
+                    cursor += written;
+                    bytes -= static_cast<size_t>(written);
+                    length += static_cast<size_t>(written);
+                }
+            }
+
+            /**
+             * @brief Reads bytes from a position of the file.
+             * @param offset Position of the first byte.
+             * @param out Destination.
+             * @param bytes Number of bytes, offset + bytes must not exceed size().
+             * @returns void
+             * @throw std::runtime_error if the read fails.
+             */
+            void read(size_t offset, void *out, size_t bytes) const
+            {
+                char *cursor = static_cast<char *>(out);
+                while (bytes != 0)
+                {
+                    ssize_t got = ::pread(fd, cursor, bytes, static_cast<off_t>(offset));
+                    if (got <= 0)
+                    {
+                        if (got < 0 && errno == EINTR)
+                        {
+                            continue;
+                        }
+                        throw std::runtime_error("Cannot read spill file");
+                    }
+                    cursor += got;
+                    offset += static_cast<size_t>(got);
+                    bytes -= static_cast<size_t>(got);
+                }
+            }
+
+            /**
+             * @brief Returns the size of the file.
+             * @param None
+             * @returns Number of bytes written.
+             * @throw None
+             */
+            size_t size() const { return length; }
+        };
+
+        /**
+         * @brief One sorted run: a segment of a spill file.
+         * The runs of a pass share one file, so an external sort keeps at most a few files open.
+         */
+        struct SpilledRun
+        {
+            std::shared_ptr<SpillFile> file;
+            size_t offset; // First byte of the run
+            size_t bytes;  // Length of the run
+        };
+
+        /**
+         * @brief k-way merge of sorted runs stored in spill files, each read through its own buffer.
+         * A binary heap over the runs' current elements yields the next element of the merged order.
+         */
+        template <typename T, typename Compare>
+        class RunMerger
+        {
+        private:
+            // Read position inside one run
+            struct Cursor
+            {
+                std::shared_ptr<SpillFile> file;
+                size_t next_offset;   // Next byte of the file to read into the buffer
+                size_t end_offset;    // One past the last byte of the run
+                std::vector<T> buffer;
+                size_t position;      // Current element of buffer
+                size_t filled;        // Valid elements in buffer
+            };
+
+            std::vector<Cursor> cursors;
+            std::vector<size_t> heap; // Indices of cursors that still have elements, next element at the front
+
+            /**
+             * @brief Reads the next block of a run into its buffer.
+             * @param cursor The run.
+             * @returns false if the run is exhausted.
+             * @throw std::runtime_error if the read fails.
+             */
+            static bool refill(Cursor &cursor)
+            {
+                size_t remaining = (cursor.end_offset - cursor.next_offset) / sizeof(T);
+                cursor.filled = std::min(remaining, cursor.buffer.size());
+                cursor.position = 0;
+                if (cursor.filled == 0)
+                {
+                    return false;
+                }
+                cursor.file->read(cursor.next_offset, cursor.buffer.data(), cursor.filled * sizeof(T));
+                cursor.next_offset += cursor.filled * sizeof(T);
+                return true;
+            }
+
+            // Orders the heap so that the run with the next element of the merged order is at the front
+            struct HeapCompare
+            {
+                const std::vector<Cursor> *cursors;
+                bool operator()(size_t a, size_t b) const
+                {
+                    const Cursor &first = (*cursors)[a];
+                    const Cursor &second = (*cursors)[b];
+                    return Compare()(second.buffer[second.position], first.buffer[first.position]);
+                }
+            };
+
+            HeapCompare heapCompare() const
+            {
+                HeapCompare compare = {&cursors};
+                return compare;
+            }
+
+        public:
+            /**
+             * @brief Constructor for RunMerger.
+             * @param runs The sorted runs to merge.
+             * @param buffer_elements Elements read per block from each run (at least 1).
+             * @returns RunMerger object.
+             * @throw std::runtime_error if a run cannot be read.
+             */
+            RunMerger(const std::vector<SpilledRun> &runs, size_t buffer_elements) : cursors(runs.size())
+            {
+                for (size_t r = 0; r < runs.size(); ++r)
+                {
+                    cursors[r].file = runs[r].file;
+                    cursors[r].next_offset = runs[r].offset;
+                    cursors[r].end_offset = runs[r].offset + runs[r].bytes;
+                    cursors[r].buffer.resize(buffer_elements);
+                    if (refill(cursors[r]))
+                    {
+                        heap.push_back(r);
+                    }
+                }
+                std::make_heap(heap.begin(), heap.end(), heapCompare());
+            }
+
+            /**
+             * @brief Checks if every run is exhausted.
+             * @param None
+             * @returns true if there is no next element.
+             * @throw None
+             */
+            bool empty() const { return heap.empty(); }
+
+            /**
+             * @brief Returns the next element of the merged order.
+             * @param None
+             * @returns A constant reference to the element, valid until pop().
+             * @throw None
+             */
+            const T &top() const
+            {
+                const Cursor &cursor = cursors[heap.front()];
+                return cursor.buffer[cursor.position];
+            }
+
+            /**
+             * @brief Moves past the next element of the merged order.
+             * @param None
+             * @returns void
+             * @throw std::runtime_error if a run cannot be read.
+             */
+            void pop()
+            {
+                std::pop_heap(heap.begin(), heap.end(), heapCompare());
+                Cursor &cursor = cursors[heap.back()];
+                if (++cursor.position == cursor.filled && !refill(cursor))
+                {
+                    heap.pop_back();
+                    return;
+                }
+                std::push_heap(heap.begin(), heap.end(), heapCompare());
+            }
+        };
+
+        /**
+         * @brief External-memory sort: the elements are sorted in runs that fit the memory budget, the runs are
+         * spilled to temporary files and merged back as a stream.
+         * When there are more runs than one merge can read within the budget, groups of runs are first merged
+         * into longer runs (multi-pass merge).
+         *
+         * @note The budget bounds the element buffers (run buffer, read buffers, pass output buffer);
+         * the merge heap adds one index per run being merged.
+         */
+        template <typename T, typename Compare>
+        class ExternalMerge
+        {
+        private:
+            static_assert(std::is_trivially_copyable<T>::value, "External sorting spills raw elements and requires a trivially copyable type");
+
+            // Smallest read buffer worth a separate run in one merge
+            static const size_t MIN_BLOCK_BYTES = 4096;
+
+            std::vector<T> in_memory;  // The whole order, when it fits the budget and nothing was spilled
+            size_t memory_position;
+            std::shared_ptr<RunMerger<T, Compare>> merger; // Final merge, when runs were spilled
+            size_t total;
+            size_t consumed;           // Elements already passed by advance()
+            size_t spilled_runs;
+            size_t merge_passes;
+            size_t peak_buffer_bytes;
+
+            /**
+             * @brief Merges runs into one new run at the end of a spill file.
+             * @param runs The runs to merge.
+             * @param buffer_elements Elements per read buffer and in the output buffer.
+             * @param merged The spill file of the pass, which receives the new run.
+             * @returns The merged run.
+             * @throw std::runtime_error if a spill file cannot be written or read.
+             */
+            static SpilledRun mergeRuns(const std::vector<SpilledRun> &runs, size_t buffer_elements,
+                                        const std::shared_ptr<SpillFile> &merged)
+            {
+                SpilledRun result = {merged, merged->size(), 0};
+                RunMerger<T, Compare> group(runs, buffer_elements);
+                std::vector<T> output;
+                output.reserve(buffer_elements);
+                while (!group.empty())
+                {
+                    output.push_back(group.top());
+                    group.pop();
+                    if (output.size() == buffer_elements)
+                    {
+                        merged->append(output.data(), output.size() * sizeof(T));
+                        output.clear();
+                    }
+                }
+                merged->append(output.data(), output.size() * sizeof(T));
+                result.bytes = merged->size() - result.offset;
+                return result;
+            }
+
+        public:
+            /**
+             * @brief Sorts elements under a memory budget.
+             * @param data The elements (copied run by run, never as a whole).
+             * @param count Number of elements.
+             * @param memory_budget Bytes available for element buffers, at least 3 elements.
+             * @param directory Directory for the spill files; empty to use $TMPDIR or /tmp.
+             * @returns ExternalMerge object, positioned at the first element of the order.
+             * @throw std::invalid_argument if the budget cannot hold 3 elements.
+             * @throw std::runtime_error if a spill file cannot be created, written or read.
+             */
+            ExternalMerge(const T *data, size_t count, size_t memory_budget, const std::string &directory)
+                : memory_position(0), total(count), consumed(0), spilled_runs(0), merge_passes(0), peak_buffer_bytes(0)
+            {
+                const size_t budget_elements = memory_budget / sizeof(T);
+                if (budget_elements < 3)
+                {
+                    throw std::invalid_argument("External sort memory budget must hold at least 3 elements");
+                }
+                if (count <= budget_elements)
+                {
+                    in_memory.assign(data, data + count); // Fits the budget, nothing to spill
+                    std::sort(in_memory.begin(), in_memory.end(), Compare());
+                    peak_buffer_bytes = count * sizeof(T);
+                    return;
+                }
+
+                // Phase 1: sort budget-sized runs and spill them
+                std::vector<SpilledRun> runs;
+                {
+                    std::shared_ptr<SpillFile> spill = std::make_shared<SpillFile>(directory);
+                    std::vector<T> run;
+                    run.reserve(budget_elements);
+                    for (size_t first = 0; first < count; first += budget_elements)
+                    {
+                        run.assign(data + first, data + std::min(count, first + budget_elements));
+                        std::sort(run.begin(), run.end(), Compare());
+                        SpilledRun spilled = {spill, spill->size(), run.size() * sizeof(T)};
+                        spill->append(run.data(), spilled.bytes);
+                        runs.push_back(spilled);
+                    }
+                    peak_buffer_bytes = budget_elements * sizeof(T);
+                }
+                spilled_runs = runs.size();
+
+                // Phase 2: one read buffer per merged run plus one output buffer must fit the budget,
+                // with blocks of MIN_BLOCK_BYTES when the budget allows and of one element otherwise
+                const size_t blocks = memory_budget / MIN_BLOCK_BYTES;
+                const size_t fan_in = std::min(blocks > 3 ? blocks - 1 : 2, budget_elements - 1);
+                while (runs.size() > fan_in)
+                {
+                    const size_t buffer_elements = std::max<size_t>(1, budget_elements / (fan_in + 1));
+                    std::shared_ptr<SpillFile> pass_file = std::make_shared<SpillFile>(directory);
+                    std::vector<SpilledRun> merged;
+                    for (size_t first = 0; first < runs.size(); first += fan_in)
+                    {
+                        std::vector<SpilledRun> group(runs.begin() + first, runs.begin() + std::min(runs.size(), first + fan_in));
+                        merged.push_back(group.size() == 1 ? group.front() : mergeRuns(group, buffer_elements, pass_file));
+                    }
+                    runs.swap(merged);
+                    ++merge_passes;
+                    peak_buffer_bytes = std::max(peak_buffer_bytes, buffer_elements * (fan_in + 1) * sizeof(T));
+                }
+                const size_t buffer_elements = std::max<size_t>(1, budget_elements / runs.size());
+                merger = std::make_shared<RunMerger<T, Compare>>(runs, buffer_elements);
+                ++merge_passes;
+                peak_buffer_bytes = std::max(peak_buffer_bytes, buffer_elements * runs.size() * sizeof(T));
+            }
+
+            /**
+             * @brief Checks if the whole order was consumed.
+             * @param None
+             * @returns true if there is no current element.
+             * @throw None
+             */
+            bool done() const
+            {
+                return merger ? merger->empty() : memory_position == in_memory.size();
+            }
+
+            /**
+             * @brief Returns the current element of the order.
+             * @param None
+             * @returns A constant reference to the element, valid until advance().
+             * @throw None
+             */
+            const T &current() const
+            {
+                return merger ? merger->top() : in_memory[memory_position];
+            }
+
+            /**
+             * @brief Moves to the next element of the order.
+             * @param None
+             * @returns void
+             * @throw std::runtime_error if a spill file cannot be read.
+             */
+            void advance()
+            {
+                ++consumed;
+                if (merger)
+                {
+                    merger->pop();
+                }
+                else
+                {
+                    ++memory_position;
+                }
+            }
+
+            /**
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The number of elements.
+             * @throw None
+             */
+            size_t size() const { return total; }
+
+            /**
+             * @brief Returns the current position in the order.
+             * @param None
+             * @returns Number of elements already passed, size() once the order is consumed.
+             * @throw None
+             */
+            size_t position() const { return consumed; }
+
+            /**
+             * @brief Returns the number of sorted runs written to spill files.
+             * @param None
+             * @returns 0 if the elements fit the budget.
+             * @throw None
+             */
+            size_t spilledRuns() const { return spilled_runs; }
+
+            /**
+             * @brief Returns the number of merge passes, including the final streaming merge.
+             * @param None
+             * @returns 0 if the elements fit the budget.
+             * @throw None
+             */
+            size_t mergePasses() const { return merge_passes; }
+
+            /**
+             * @brief Returns the largest amount of element buffer memory held at once.
+             * @param None
+             * @returns Bytes, never more than the budget.
+             * @throw None
+             */
+            size_t peakBufferBytes() const { return peak_buffer_bytes; }
+        };
+    }
+}
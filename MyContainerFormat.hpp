@@ -0,0 +1,336 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <cstddef>     // for size_t
+#include <cstdio>      // for std::snprintf
+#include <cstring>     // for std::memcpy
+#include <limits>      // for std::numeric_limits
+#include <locale>      // for std::locale
+#include <ostream>     // for std::ostream
+#include <string>      // for std::string
+#include <type_traits> // for std::true_type, std::decay
+#include <vector>      // for std::vector
+
+namespace my_cont_ns
+{
+    namespace detail
+    {
+        /**
+         * @brief Output buffer of the formatting engine.
+         * Text is collected in one large local buffer and handed to the stream with a single write per buffer-full,
+         * instead of one formatted insertion per element.
+         */
+        class FormatBuffer
+        {
+        private:
+            static const size_t CAPACITY = 1 << 16;
+
+            std::ostream &os;
+            std::vector<char> storage;
+            size_t used;
+
+            FormatBuffer(const FormatBuffer &);
+            FormatBuffer &operator=(const FormatBuffer &);
+
+        public:
+            /**
+             * @brief Constructor for FormatBuffer.
+             * @param os The stream that receives the text.
+             * @returns FormatBuffer object.
+             * @throw std::bad_alloc if the buffer cannot be allocated.
+             */
+            explicit FormatBuffer(std::ostream &os) : os(os), storage(CAPACITY), used(0) {}
+
+            /**
+             * @brief Destructor, writes whatever is still buffered.
+             * @param None
+             * @returns None
+             * @throw None
+             */
+            ~FormatBuffer()
+            {
+                flush();
+            }
+
+            /**
+             * @brief Writes the buffered text to the stream.
+             * @param None
+             * @returns void
+             * @throw None
+             */
+            void flush()
+            {
+                if (used != 0)
+                {
+                    os.write(storage.data(), static_cast<std::streamsize>(used));
+                    used = 0;
+                }
+            }
+
+            /**
+             * @brief Returns a pointer with room for at least length characters.
+             * The caller fills them and then calls commit().
+             * @param length Maximum number of characters that will be written.
+             * @returns Pointer into the buffer.
+             * @throw None
+             */
+            char *reserve(size_t length)
+            {
+                if (CAPACITY - used < length)
+                {
+                    flush();
+                }
+                return storage.data() + used;
+            }
+
+            /**
+             * @brief Marks characters written through reserve() as used.
+             * @param length Number of characters written.
+             * @returns void
+             * @throw None
+             */
+            void commit(size_t length)
+            {
+                used += length;
+            }
+
+            /**
+             * @brief Appends raw text.
+             * @param text The characters to append.
+             * @param length Number of characters.
+             * @returns void
+             * @throw None
+             */
+            void append(const char *text, size_t length)
+            {
+                if (length > CAPACITY)
+                {
+                    flush();
+                    os.write(text, static_cast<std::streamsize>(length)); // Too large to buffer, write through
+                    return;
+                }
+                std::memcpy(reserve(length), text, length);
+                used += length;
+            }
+
+            /**
+             * @brief Returns the stream behind the buffer, for values the engine cannot format itself.
+             * Everything buffered so far is written first, so the output order is kept.
+             * @param None
+             * @returns Reference to the stream.
+             * @throw None
+             */
+            std::ostream &stream()
+            {
+                flush();
+                return os;
+            }
+        };
+
+        /**
+         * @brief Writes an unsigned integer in decimal, two digits per step.
+         * @param value The value.
+         * @param out Destination with room for 20 characters.
+         * @returns Number of characters written.
+         * @throw None
+         */
+        inline size_t formatUnsigned(unsigned long long value, char *out)
+        {
+            static const char digit_pairs[] =
+                "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                "8081828384858687888990919293949596979899";
+            char reversed[20];
+            char *cursor = reversed + sizeof(reversed);
+            while (value >= 100)
+            {
+                unsigned pair = static_cast<unsigned>(value % 100) * 2;
+                value /= 100;
+                *--cursor = digit_pairs[pair + 1];
+                *--cursor = digit_pairs[pair];
+            }
+            if (value >= 10)
+            {
+                unsigned pair = static_cast<unsigned>(value) * 2;
+                *--cursor = digit_pairs[pair + 1];
+                *--cursor = digit_pairs[pair];
+            }
+            else
+            {
+                *--cursor = static_cast<char>('0' + value);
+            }
+            size_t length = static_cast<size_t>(reversed + sizeof(reversed) - cursor);
+            std::memcpy(out, cursor, length);
+            return length;
+        }
+
+        /**
+         * @brief Formats an integer (signed or unsigned) the way std::ostream does with default flags.
+         * @param buffer The output buffer.
+         * @param value The value.
+         * @returns void
+         * @throw None
+         */
+        template <typename Integer>
+        void formatInteger(FormatBuffer &buffer, Integer value)
+        {
+            char *out = buffer.reserve(21);
+            size_t length = 0;
+            unsigned long long magnitude = static_cast<unsigned long long>(value);
+            if (std::numeric_limits<Integer>::is_signed && value < 0)
+            {
+                out[length++] = '-';
+                magnitude = 0ull - magnitude; // Also correct for the most negative value
+            }
+            length += formatUnsigned(magnitude, out + length);
+            buffer.commit(length);
+        }
+
+        /**
+         * @brief Formats a floating point value exactly like std::ostream with default flags (%g at the stream precision).
+         * @param buffer The output buffer.
+         * @param value The value.
+         * @param precision The stream precision.
+         * @returns void
+         * @throw None
+         */
+        inline void formatFloating(FormatBuffer &buffer, long double value, int precision)
+        {
+            char *out = buffer.reserve(64);
+            int length = std::snprintf(out, 64, "%.*Lg", precision, value);
+            if (length < 0 || length >= 64)
+            {
+                buffer.stream() << value; // Does not fit the fast path (e.g. a huge precision)
+                return;
+            }
+            buffer.commit(static_cast<size_t>(length));
+        }
+
+        // == Per-type formatting of the types the engine handles itself ==
+
+        inline void formatFast(FormatBuffer &buffer, char value, int) { buffer.append(&value, 1); }
+
+        inline void formatFast(FormatBuffer &buffer, signed char value, int) { buffer.append(reinterpret_cast<const char *>(&value), 1); }
+
+        inline void formatFast(FormatBuffer &buffer, unsigned char value, int) { buffer.append(reinterpret_cast<const char *>(&value), 1); }
+
+        inline void formatFast(FormatBuffer &buffer, bool value, int) { buffer.append(value ? "1" : "0", 1); }
+
+        inline void formatFast(FormatBuffer &buffer, short value, int) { formatInteger(buffer, value); }
+
+        inline void formatFast(FormatBuffer &buffer, unsigned short value, int) { formatInteger(buffer, value); }
+
+        inline void formatFast(FormatBuffer &buffer, int value, int) { formatInteger(buffer, value); }
+
+        inline void formatFast(FormatBuffer &buffer, unsigned value, int) { formatInteger(buffer, value); }
+
+        inline void formatFast(FormatBuffer &buffer, long value, int) { formatInteger(buffer, value); }
+
+        inline void formatFast(FormatBuffer &buffer, unsigned long value, int) { formatInteger(buffer, value); }
+
+        inline void formatFast(FormatBuffer &buffer, long long value, int) { formatInteger(buffer, value); }
+
+        inline void formatFast(FormatBuffer &buffer, unsigned long long value, int) { formatInteger(buffer, value); }
+
+        inline void formatFast(FormatBuffer &buffer, float value, int precision) { formatFloating(buffer, value, precision); }
+
+        inline void formatFast(FormatBuffer &buffer, double value, int precision) { formatFloating(buffer, value, precision); }
+
+        inline void formatFast(FormatBuffer &buffer, long double value, int precision) { formatFloating(buffer, value, precision); }
+
+        inline void formatFast(FormatBuffer &buffer, const std::string &value, int) { buffer.append(value.data(), value.size()); }
+
+        /**
+         * @brief true for the types formatFast() handles, every other type goes through its own operator<<.
+         */
+        template <typename T> struct HasFastFormat : std::false_type {};
+        template <> struct HasFastFormat<char> : std::true_type {};
+        template <> struct HasFastFormat<signed char> : std::true_type {};
+        template <> struct HasFastFormat<unsigned char> : std::true_type {};
+        template <> struct HasFastFormat<bool> : std::true_type {};
+        template <> struct HasFastFormat<short> : std::true_type {};
+        template <> struct HasFastFormat<unsigned short> : std::true_type {};
+        template <> struct HasFastFormat<int> : std::true_type {};
+        template <> struct HasFastFormat<unsigned> : std::true_type {};
+        template <> struct HasFastFormat<long> : std::true_type {};
+        template <> struct HasFastFormat<unsigned long> : std::true_type {};
+        template <> struct HasFastFormat<long long> : std::true_type {};
+        template <> struct HasFastFormat<unsigned long long> : std::true_type {};
+        template <> struct HasFastFormat<float> : std::true_type {};
+        template <> struct HasFastFormat<double> : std::true_type {};
+        template <> struct HasFastFormat<long double> : std::true_type {};
+        template <> struct HasFastFormat<std::string> : std::true_type {};
+
+        /**
+         * @brief Formats one value with the engine.
+         * @param buffer The output buffer.
+         * @param value The value.
+         * @param precision The stream precision (used by floating point values).
+         * @returns void
+         * @throw None
+         */
+        template <typename T>
+        void formatValue(FormatBuffer &buffer, const T &value, int precision, std::true_type)
+        {
+            formatFast(buffer, value, precision);
+        }
+
+        /**
+         * @brief Formats one value through its own operator<<.
+         * @param buffer The output buffer.
+         * @param value The value.
+         * @param precision Unused.
+         * @returns void
+         * @throw Whatever T's operator<< throws.
+         */
+        template <typename T>
+        void formatValue(FormatBuffer &buffer, const T &value, int, std::false_type)
+        {
+            buffer.stream() << value;
+        }
+
+        /**
+         * @brief Checks whether a stream is in its default formatting state.
+         * Only then does the engine produce exactly the text operator<< would, so other states take the slow path.
+         * @param os The stream.
+         * @returns true if the fast path may be used.
+         * @throw None
+         */
+        inline bool hasDefaultFormatting(const std::ostream &os)
+        {
+            return os.flags() == (std::ios_base::skipws | std::ios_base::dec) && os.width() == 0 &&
+                   os.getloc() == std::locale::classic();
+        }
+
+        /**
+         * @brief Writes count elements, each followed by the separator, through one local buffer.
+         * @param os The output stream.
+         * @param count Number of elements.
+         * @param at Callable returning the element at a position.
+         * @param separator Text written after every element.
+         * @returns void
+         * @throw Whatever the elements' operator<< throws on the slow path.
+         */
+        template <typename Accessor>
+        void writeFormatted(std::ostream &os, size_t count, Accessor at, const std::string &separator)
+        {
+            if (!hasDefaultFormatting(os))
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    os << at(i) << separator; // Keep every stream setting (width, base, locale, ...)
+                }
+                return;
+            }
+
+            FormatBuffer buffer(os);
+            const int precision = static_cast<int>(os.precision());
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto &value = at(i);
+                formatValue(buffer, value, precision, HasFastFormat<typename std::decay<decltype(value)>::type>());
+                buffer.append(separator.data(), separator.size());
+            }
+        }
+    }
+}
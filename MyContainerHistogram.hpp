@@ -0,0 +1,366 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <atomic>    // for std::atomic
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstddef>   // for size_t
+#include <iomanip>   // for std::setw
+#include <sstream>   // for std::ostringstream
+#include <string>    // for std::string
+
+/**
+ * @brief Opt-in latency histograms.
+ * Compile with -DMYCONTAINER_HISTOGRAMS to time every add(), remove() and iterator construction
+ * into process-wide log-bucketed histograms (see LatencyHistograms::instance()).
+ * Without the flag the timing code is compiled out.
+ */
+#ifdef MYCONTAINER_HISTOGRAMS
+#define MYCONTAINER_LATENCY_SCOPE(operation) my_cont_ns::detail::LatencyScope latency_scope((operation))
+#else
+#define MYCONTAINER_LATENCY_SCOPE(operation)
+#endif
+
+namespace my_cont_ns
+{
+    /**
+     * @brief Operations timed by the latency histograms.
+     * The iterator entries follow the order of ContainerStats::iteratorName().
+     */
+    enum class LatencyOp
+    {
+        Add,
+        Remove,
+        AscendingOrder,
+        DescendingOrder,
+        SideCrossOrder,
+        ReverseOrder,
+        Order,
+        MiddleOutOrder,
+        DistinctAscendingOrder,
+        GroupedAscendingOrder,
+        Count // Number of operations, not an operation
+    };
+
+    /**
+     * @brief HDR-style histogram of latencies in nanoseconds.
+     * Values are bucketed by their power of two and split into SUB_BUCKETS linear sub-buckets,
+     * so every recorded value is kept with a relative error below 1 / SUB_BUCKETS.
+     * Recording is a few instructions plus one relaxed atomic increment.
+     */
+    class LatencyHistogram
+    {
+    public:
+        static const unsigned SUB_BITS = 4;                         // log2 of the sub-buckets per power of two
+        static const unsigned SUB_BUCKETS = 1u << SUB_BITS;         // Linear sub-buckets per power of two
+        static const unsigned MAGNITUDES = 48;                      // Values up to 2^48 ns (about 3 days)
+        static const unsigned BUCKETS = MAGNITUDES * SUB_BUCKETS;
+
+    private:
+        std::atomic<unsigned long long> buckets[BUCKETS];
+        std::atomic<unsigned long long> total;
+        std::atomic<unsigned long long> sum;
+        std::atomic<unsigned long long> maximum;
+
+        /**
+         * @brief Returns the bucket of a value.
+         * @param nanos The value.
+         * @returns Index into buckets.
+         * @throw None
+         */
+        static unsigned bucketOf(unsigned long long nanos)
+        {
+            if (nanos < SUB_BUCKETS)
+            {
+                return static_cast<unsigned>(nanos); // Small values are exact
+            }
+            unsigned magnitude = 63u - static_cast<unsigned>(__builtin_clzll(nanos)); // floor(log2(nanos))
+            if (magnitude >= MAGNITUDES)
+            {
+                return BUCKETS - 1;
+            }
+            unsigned sub = static_cast<unsigned>(nanos >> (magnitude - SUB_BITS)) & (SUB_BUCKETS - 1);
+            return (magnitude - SUB_BITS + 1) * SUB_BUCKETS + sub;
+        }
+
+        /**
+         * @brief Returns the largest value that falls into a bucket.
+         * @param bucket Index into buckets.
+         * @returns The upper bound of the bucket.
+         * @throw None
+         */
+        static unsigned long long upperBoundOf(unsigned bucket)
+        {
+            if (bucket < SUB_BUCKETS)
+            {
+                return bucket;
+            }
+            unsigned magnitude = bucket / SUB_BUCKETS + SUB_BITS - 1;
+            unsigned long long sub = bucket % SUB_BUCKETS;
+            unsigned long long width = 1ull << (magnitude - SUB_BITS);
+            return ((SUB_BUCKETS + sub) << (magnitude - SUB_BITS)) + width - 1;
+        }
+
+        LatencyHistogram(const LatencyHistogram &);
+        LatencyHistogram &operator=(const LatencyHistogram &);
+
+    public:
+        /**
+         * @brief Default constructor, the histogram starts empty.
+         * @param None
+         * @returns LatencyHistogram object.
+         * @throw None
+         */
+        LatencyHistogram()
+        {
+            reset();
+        }
+
+        /**
+         * @brief Records one latency.
+         * @param nanos The latency in nanoseconds.
+         * @returns void
+         * @throw None
+         */
+        void record(unsigned long long nanos)
+        {
+            buckets[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+            total.fetch_add(1, std::memory_order_relaxed);
+            sum.fetch_add(nanos, std::memory_order_relaxed);
+            unsigned long long seen = maximum.load(std::memory_order_relaxed);
+            while (nanos > seen && !maximum.compare_exchange_weak(seen, nanos, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        /**
+         * @brief Returns the number of recorded latencies.
+         * @param None
+         * @returns The count.
+         * @throw None
+         */
+        unsigned long long count() const { return total.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the largest recorded latency.
+         * @param None
+         * @returns The maximum in nanoseconds, 0 when empty.
+         * @throw None
+         */
+        unsigned long long max() const { return maximum.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Returns the mean recorded latency.
+         * @param None
+         * @returns The mean in nanoseconds, 0 when empty.
+         * @throw None
+         */
+        double mean() const
+        {
+            unsigned long long n = count();
+            return n == 0 ? 0.0 : static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(n);
+        }
+
+        /**
+         * @brief Returns the latency below which the given percentage of recordings fall.
+         * @param percentile Percentile in [0, 100], e.g. 99 or 99.9.
+         * @returns The upper bound of the bucket holding that rank (never above max()), 0 when empty.
+         * @throw None
+         */
+        unsigned long long percentile(double percentile) const
+        {
+            unsigned long long n = count();
+            if (n == 0)
+            {
+                return 0;
+            }
+            double wanted = percentile / 100.0 * static_cast<double>(n);
+            unsigned long long rank = static_cast<unsigned long long>(wanted);
+            if (static_cast<double>(rank) < wanted || rank == 0)
+            {
+                ++rank; // Nearest rank, at least the first recording
+            }
+            unsigned long long seen = 0;
+            for (unsigned bucket = 0; bucket < BUCKETS; ++bucket)
+            {
+                seen += buckets[bucket].load(std::memory_order_relaxed);
+                if (seen >= rank)
+                {
+                    unsigned long long bound = upperBoundOf(bucket);
+                    return bound < max() ? bound : max();
+                }
+            }
+            return max();
+        }
+
+        /**
+         * @brief Drops every recording.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void reset()
+        {
+            for (unsigned bucket = 0; bucket < BUCKETS; ++bucket)
+            {
+                buckets[bucket].store(0, std::memory_order_relaxed);
+            }
+            total.store(0, std::memory_order_relaxed);
+            sum.store(0, std::memory_order_relaxed);
+            maximum.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Process-wide latency histograms, one per LatencyOp.
+     */
+    class LatencyHistograms
+    {
+    private:
+        LatencyHistogram histograms[static_cast<size_t>(LatencyOp::Count)];
+
+        LatencyHistograms() {}
+        LatencyHistograms(const LatencyHistograms &);
+        LatencyHistograms &operator=(const LatencyHistograms &);
+
+    public:
+        /**
+         * @brief Returns the process-wide histograms.
+         * @param None
+         * @returns Reference to the histograms.
+         * @throw None
+         */
+        static LatencyHistograms &instance()
+        {
+            static LatencyHistograms registry;
+            return registry;
+        }
+
+        /**
+         * @brief Returns the name of an operation.
+         * @param operation The operation.
+         * @returns The operation name.
+         * @throw None
+         */
+        static const char *operationName(LatencyOp operation)
+        {
+            static const char *const names[static_cast<size_t>(LatencyOp::Count)] = {
+                "add", "remove", "AscendingOrder", "DescendingOrder", "SideCrossOrder", "ReverseOrder",
+                "Order", "MiddleOutOrder", "DistinctAscendingOrder", "GroupedAscendingOrder"};
+            size_t index = static_cast<size_t>(operation);
+            return index < static_cast<size_t>(LatencyOp::Count) ? names[index] : "Unknown";
+        }
+
+        /**
+         * @brief Returns the histogram of one operation.
+         * @param operation The operation.
+         * @returns Reference to its histogram.
+         * @throw None
+         */
+        LatencyHistogram &histogram(LatencyOp operation)
+        {
+            return histograms[static_cast<size_t>(operation)];
+        }
+
+        /**
+         * @brief Returns a percentile of one operation.
+         * @param operation The operation.
+         * @param percentile Percentile in [0, 100].
+         * @returns The latency in nanoseconds (see LatencyHistogram::percentile()).
+         * @throw None
+         */
+        unsigned long long percentile(LatencyOp operation, double percentile)
+        {
+            return histogram(operation).percentile(percentile);
+        }
+
+        /**
+         * @brief Drops the recordings of every operation.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void reset()
+        {
+            for (size_t i = 0; i < static_cast<size_t>(LatencyOp::Count); ++i)
+            {
+                histograms[i].reset();
+            }
+        }
+
+        /**
+         * @brief Formats count, p50, p90, p99, p99.9 and max of every operation that was recorded.
+         * @param None
+         * @returns One table row per operation, latencies in nanoseconds.
+         * @throw None
+         */
+        std::string toText()
+        {
+            std::ostringstream out;
+            out << std::setw(24) << "operation" << std::setw(10) << "count" << std::setw(12) << "p50 [ns]"
+                << std::setw(12) << "p90 [ns]" << std::setw(12) << "p99 [ns]" << std::setw(12) << "p99.9 [ns]"
+                << std::setw(12) << "max [ns]" << "\n";
+            for (size_t i = 0; i < static_cast<size_t>(LatencyOp::Count); ++i)
+            {
+                const LatencyHistogram &h = histograms[i];
+                if (h.count() == 0)
+                {
+                    continue;
+                }
+                out << std::setw(24) << operationName(static_cast<LatencyOp>(i)) << std::setw(10) << h.count()
+                    << std::setw(12) << h.percentile(50) << std::setw(12) << h.percentile(90)
+                    << std::setw(12) << h.percentile(99) << std::setw(12) << h.percentile(99.9)
+                    << std::setw(12) << h.max() << "\n";
+            }
+            return out.str();
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Times the enclosing scope into the histogram of one operation.
+         */
+        class LatencyScope
+        {
+        private:
+            LatencyOp operation;
+            std::chrono::steady_clock::time_point start;
+
+            LatencyScope(const LatencyScope &);
+            LatencyScope &operator=(const LatencyScope &);
+
+        public:
+            /**
+             * @brief Constructor for LatencyScope, starts the clock.
+             * @param operation The operation being timed.
+             * @returns LatencyScope object.
+             * @throw None
+             */
+            explicit LatencyScope(LatencyOp operation) : operation(operation), start(std::chrono::steady_clock::now()) {}
+
+            /**
+             * @brief Destructor, records the elapsed time.
+             * @param None
+             * @returns None
+             * @throw None
+             */
+            ~LatencyScope()
+            {
+                std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+                LatencyHistograms::instance().histogram(operation).record(static_cast<unsigned long long>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        };
+
+        /**
+         * @brief Maps an iterator type index (see ContainerStats::iteratorName()) to its LatencyOp.
+         * @param kind The iterator type index.
+         * @returns The matching operation.
+         * @throw None
+         */
+        inline LatencyOp iteratorLatencyOp(size_t kind)
+        {
+            return static_cast<LatencyOp>(static_cast<size_t>(LatencyOp::AscendingOrder) + kind);
+        }
+    }
+}
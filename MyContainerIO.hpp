@@ -0,0 +1,592 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint32_t, uint64_t
+#include <cstdio>      // for std::rename, std::remove
+#include <cstring>     // for std::memcpy
+#include <fstream>     // for std::ofstream
+#include <stdexcept>   // for std::runtime_error
+#include <string>      // for std::string
+#include <type_traits> // for std::is_trivially_copyable
+#include <vector>      // for std::vector
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+
+namespace my_cont_ns
+{
+    namespace detail
+    {
+        /**
+         * @brief Fixed-size header at the start of every file written by MyContainer::save().
+         * Fields are stored in host byte order; a file from a host with the other byte order fails the magic check.
+         * Version 1 files end after the payload, version 2 files continue with an IndexHeader.
+         */
+        struct FileHeader
+        {
+            static const uint32_t MAGIC = 0x5443594d; // "MYCT" when read as bytes on a little-endian host
+            static const uint32_t VERSION = 2;        // Version written by save(), load() also reads version 1
+            static const uint32_t RAW_PAYLOAD = 0;    // sizeof(T) bytes per element
+            static const uint32_t STRING_PAYLOAD = 1; // uint64_t length, then the characters, per element
+
+            uint32_t magic;
+            uint32_t version;
+            uint32_t payload_kind;  // RAW_PAYLOAD or STRING_PAYLOAD
+            uint32_t element_size;  // sizeof(T) for raw payloads, 0 for strings
+            uint64_t count;         // Number of elements
+            uint64_t payload_bytes; // Bytes following the header
+            uint64_t checksum;      // PayloadChecksum of the payload
+        };
+
+        /**
+         * @brief Header of the sorted index section that follows the payload in version 2 files.
+         * The section holds the ascending permutation (permutation[i] is the insertion index of the i-th smallest
+         * element) followed by the start position of every run of equal values in that order.
+         */
+        struct IndexHeader
+        {
+            static const uint32_t MAGIC = 0x5849594d; // "MYIX" when read as bytes on a little-endian host
+
+            uint32_t magic;
+            uint32_t index_width;       // Bytes per stored index: 4 or 8, 0 when the file has no sorted index
+            uint64_t permutation_count; // Equal to FileHeader::count when the index is present
+            uint64_t run_count;         // Number of runs of equal values
+            uint64_t checksum;          // PayloadChecksum of the permutation and run starts
+        };
+
+        /**
+         * @brief Sorted index of a container, as saved to and loaded from the index section.
+         */
+        struct SortedIndex
+        {
+            std::vector<size_t> permutation; // Insertion index of each element of the ascending order
+            std::vector<size_t> run_starts;  // Ascending-order position of the first element of every run of equal values
+        };
+
+        /**
+         * @brief Streaming payload checksum: FNV-1a applied to 8-byte words instead of single bytes.
+         * Every step is a bijection of the state, so any change confined to one word is always detected,
+         * at an eighth of the multiplications of byte-wise FNV-1a. Pieces may be fed in any sizes.
+         */
+        class PayloadChecksum
+        {
+        private:
+            static const uint64_t PRIME = 1099511628211ull;
+
+            uint64_t hash;
+            unsigned char pending[8]; // Bytes of a word that is not complete yet
+            size_t pending_length;
+
+            void mixWord(uint64_t word)
+            {
+                hash ^= word;
+                hash *= PRIME;
+            }
+
+        public:
+            /**
+             * @brief Default constructor, starts an empty checksum.
+             * @param None
+             * @returns PayloadChecksum object.
+             * @throw None
+             */
+            PayloadChecksum() : hash(14695981039346656037ull), pending_length(0) {}
+
+            /**
+             * @brief Adds bytes to the checksum.
+             * @param data The bytes.
+             * @param length Number of bytes.
+             * @returns void
+             * @throw None
+             */
+            void update(const void *data, size_t length)
+            {
+                const unsigned char *bytes = static_cast<const unsigned char *>(data);
+                while (pending_length != 0 && length != 0)
+                {
+                    pending[pending_length++] = *bytes++;
+                    --length;
+                    if (pending_length == sizeof(pending))
+                    {
+                        uint64_t word;
+                        std::memcpy(&word, pending, sizeof(word));
+                        mixWord(word);
+                        pending_length = 0;
+                    }
+                }
+                for (; length >= sizeof(uint64_t); length -= sizeof(uint64_t), bytes += sizeof(uint64_t))
+                {
+                    uint64_t word;
+                    std::memcpy(&word, bytes, sizeof(word)); // Payloads are not necessarily aligned
+                    mixWord(word);
+                }
+                if (length != 0) // bytes may be null for an empty payload, and memcpy must not see a null pointer
+                {
+                    std::memcpy(pending + pending_length, bytes, length);
+                    pending_length += length;
+                }
+            }
+
+            /**
+             * @brief Returns the checksum of every byte added so far.
+             * @param None
+             * @returns The checksum.
+             * @throw None
+             */
+            uint64_t value() const
+            {
+                uint64_t result = hash;
+                for (size_t i = 0; i < pending_length; ++i)
+                {
+                    result ^= pending[i];
+                    result *= PRIME;
+                }
+                result ^= result >> 32; // Let the high bits reach the low bits
+                return result * PRIME;
+            }
+        };
+
+        /**
+         * @brief Read-only memory mapping of a whole file, unmapped on destruction.
+         */
+        class MappedFile
+        {
+        private:
+            const unsigned char *bytes;
+            size_t length;
+
+            MappedFile(const MappedFile &);
+            MappedFile &operator=(const MappedFile &);
+
+        public:
+            /**
+             * @brief Constructor for MappedFile, maps the file.
+             * @param path The file to map.
+             * @returns MappedFile object.
+             * @throw std::runtime_error if the file cannot be opened or mapped.
+             */
+            explicit MappedFile(const std::string &path) : bytes(NULL), length(0)
+            {
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    throw std::runtime_error("Cannot open file: " + path);
+                }
+                struct stat info;
+                if (::fstat(fd, &info) != 0)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot stat file: " + path);
+                }
+                length = static_cast<size_t>(info.st_size);
+                if (length != 0)
+                {
+                    void *mapping = ::mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (mapping == MAP_FAILED)
+                    {
+                        ::close(fd);
+                        throw std::runtime_error("Cannot map file: " + path);
+                    }
+                    ::madvise(mapping, length, MADV_SEQUENTIAL); // Payloads are read front to back
+                    bytes = static_cast<const unsigned char *>(mapping);
+                }
+                ::close(fd); // The mapping keeps the file contents reachable
+            }
+
+            /**
+             * @brief Destructor, unmaps the file.
+             * @param None
+             * @returns None
+             * @throw None
+             */
+            ~MappedFile()
+            {
+                if (bytes != NULL)
+                {
+                    ::munmap(const_cast<unsigned char *>(bytes), length);
+                }
+            }
+
+            const unsigned char *data() const { return bytes; }
+
+            size_t size() const { return length; }
+        };
+
+        /**
+         * @brief Converts elements to and from the payload of a saved file.
+         * The primary template handles trivially copyable types as one raw block.
+         */
+        template <typename T, bool Raw = std::is_trivially_copyable<T>::value>
+        struct ElementCodec
+        {
+            static const uint32_t PAYLOAD_KIND = FileHeader::RAW_PAYLOAD;
+            static const uint32_t ELEMENT_SIZE = sizeof(T);
+
+            /**
+             * @brief Computes the payload size and checksum.
+             * @param elements The elements to save.
+             * @param checksum Receives the payload checksum.
+             * @returns The payload size in bytes.
+             * @throw None
+             */
+            static uint64_t describe(const std::vector<T> &elements, uint64_t &checksum)
+            {
+                PayloadChecksum payload;
+                payload.update(elements.data(), elements.size() * sizeof(T));
+                checksum = payload.value();
+                return elements.size() * sizeof(T);
+            }
+
+            /**
+             * @brief Writes the payload.
+             * @param out The output file.
+             * @param elements The elements to save.
+             * @returns void
+             * @throw None
+             */
+            static void write(std::ostream &out, const std::vector<T> &elements)
+            {
+                out.write(reinterpret_cast<const char *>(elements.data()), static_cast<std::streamsize>(elements.size() * sizeof(T)));
+            }
+
+            /**
+             * @brief Reads count elements from a payload.
+             * @param payload The payload bytes.
+             * @param payload_bytes Size of the payload.
+             * @param count Number of elements in the payload.
+             * @param out Receives the elements.
+             * @returns true if the payload holds exactly count elements.
+             * @throw std::bad_alloc if the elements cannot be allocated.
+             */
+            static bool read(const unsigned char *payload, uint64_t payload_bytes, uint64_t count, std::vector<T> &out)
+            {
+                if (payload_bytes / sizeof(T) != count || payload_bytes % sizeof(T) != 0)
+                {
+                    return false;
+                }
+                out.resize(static_cast<size_t>(count));
+                if (count != 0)
+                {
+                    std::memcpy(out.data(), payload, static_cast<size_t>(payload_bytes));
+                }
+                return true;
+            }
+        };
+
+        /**
+         * @brief Codec for std::string: every element is a uint64_t length followed by its characters.
+         */
+        template <>
+        struct ElementCodec<std::string, false>
+        {
+            static const uint32_t PAYLOAD_KIND = FileHeader::STRING_PAYLOAD;
+            static const uint32_t ELEMENT_SIZE = 0;
+
+            static uint64_t describe(const std::vector<std::string> &elements, uint64_t &checksum)
+            {
+                uint64_t bytes = 0;
+                PayloadChecksum payload;
+                for (size_t i = 0; i < elements.size(); ++i)
+                {
+                    uint64_t length = elements[i].size();
+                    payload.update(&length, sizeof(length));
+                    payload.update(elements[i].data(), elements[i].size());
+                    bytes += sizeof(length) + length;
+                }
+                checksum = payload.value();
+                return bytes;
+            }
+
+            static void write(std::ostream &out, const std::vector<std::string> &elements)
+            {
+                for (size_t i = 0; i < elements.size(); ++i)
+                {
+                    uint64_t length = elements[i].size();
+                    out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+                    out.write(elements[i].data(), static_cast<std::streamsize>(elements[i].size()));
+                }
+            }
+
+            static bool read(const unsigned char *payload, uint64_t payload_bytes, uint64_t count, std::vector<std::string> &out)
+            {
+                if (count > payload_bytes / sizeof(uint64_t))
+                {
+                    return false; // Every element needs at least its length field
+                }
+                out.clear();
+                out.reserve(static_cast<size_t>(count));
+                uint64_t offset = 0;
+                for (uint64_t i = 0; i < count; ++i)
+                {
+                    uint64_t length;
+                    if (payload_bytes - offset < sizeof(length))
+                    {
+                        return false;
+                    }
+                    std::memcpy(&length, payload + offset, sizeof(length)); // The field may be unaligned
+                    offset += sizeof(length);
+                    if (payload_bytes - offset < length)
+                    {
+                        return false;
+                    }
+                    out.push_back(std::string(reinterpret_cast<const char *>(payload + offset), static_cast<size_t>(length)));
+                    offset += length;
+                }
+                return offset == payload_bytes;
+            }
+        };
+
+        /**
+         * @brief Other types have no binary format; using save() or load() with them does not compile.
+         */
+        template <typename T>
+        struct ElementCodec<T, false>
+        {
+            static_assert(sizeof(T) == 0, "save() and load() need a trivially copyable T or std::string");
+        };
+
+        /**
+         * @brief Appends indices to a byte buffer using a fixed width.
+         * @param values The indices.
+         * @param width Bytes per index, 4 or 8 (every index must fit).
+         * @param out Receives the encoded bytes.
+         * @returns void
+         * @throw None
+         */
+        inline void encodeIndices(const std::vector<size_t> &values, uint32_t width, std::vector<unsigned char> &out)
+        {
+            size_t offset = out.size();
+            out.resize(offset + values.size() * width);
+            for (size_t i = 0; i < values.size(); ++i, offset += width)
+            {
+                if (width == sizeof(uint32_t))
+                {
+                    uint32_t value = static_cast<uint32_t>(values[i]);
+                    std::memcpy(&out[offset], &value, sizeof(value));
+                }
+                else
+                {
+                    uint64_t value = values[i];
+                    std::memcpy(&out[offset], &value, sizeof(value));
+                }
+            }
+        }
+
+        /**
+         * @brief Reads fixed-width indices from a mapped file.
+         * @param bytes The first encoded index.
+         * @param count Number of indices.
+         * @param width Bytes per index, 4 or 8.
+         * @param out Receives the indices.
+         * @returns void
+         * @throw std::bad_alloc if the indices cannot be allocated.
+         */
+        inline void decodeIndices(const unsigned char *bytes, size_t count, uint32_t width, std::vector<size_t> &out)
+        {
+            out.resize(count);
+            for (size_t i = 0; i < count; ++i, bytes += width)
+            {
+                if (width == sizeof(uint32_t))
+                {
+                    uint32_t value;
+                    std::memcpy(&value, bytes, sizeof(value));
+                    out[i] = value;
+                }
+                else
+                {
+                    uint64_t value;
+                    std::memcpy(&value, bytes, sizeof(value));
+                    out[i] = static_cast<size_t>(value);
+                }
+            }
+        }
+
+        /**
+         * @brief Writes elements to a file in the MyContainer binary format.
+         * The file is written next to its destination and renamed over it, so readers never see a partial file.
+         * @param path The destination file.
+         * @param elements The elements to save.
+         * @param index The sorted index to store after the payload, or NULL to store none.
+         * @returns void
+         * @throw std::runtime_error if the file cannot be written.
+         */
+        template <typename T>
+        void saveElements(const std::string &path, const std::vector<T> &elements, const SortedIndex *index = NULL)
+        {
+            typedef ElementCodec<T> Codec;
+            FileHeader header;
+            header.magic = FileHeader::MAGIC;
+            header.version = FileHeader::VERSION;
+            header.payload_kind = Codec::PAYLOAD_KIND;
+            header.element_size = Codec::ELEMENT_SIZE;
+            header.count = elements.size();
+            header.payload_bytes = Codec::describe(elements, header.checksum);
+
+            IndexHeader index_header;
+            index_header.magic = IndexHeader::MAGIC;
+            index_header.index_width = 0;
+            index_header.permutation_count = 0;
+            index_header.run_count = 0;
+            std::vector<unsigned char> index_bytes;
+            if (index != NULL)
+            {
+                index_header.index_width = elements.size() <= 0xffffffffull ? sizeof(uint32_t) : sizeof(uint64_t);
+                index_header.permutation_count = index->permutation.size();
+                index_header.run_count = index->run_starts.size();
+                encodeIndices(index->permutation, index_header.index_width, index_bytes);
+                encodeIndices(index->run_starts, index_header.index_width, index_bytes);
+            }
+            PayloadChecksum index_checksum;
+            index_checksum.update(index_bytes.data(), index_bytes.size());
+            index_header.checksum = index_checksum.value();
+
+            const std::string temporary = path + ".tmp";
+            {
+                std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+                if (!out)
+                {
+                    throw std::runtime_error("Cannot open file for writing: " + temporary);
+                }
+                out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                Codec::write(out, elements);
+                out.write(reinterpret_cast<const char *>(&index_header), sizeof(index_header));
+                out.write(reinterpret_cast<const char *>(index_bytes.data()), static_cast<std::streamsize>(index_bytes.size()));
+                out.flush();
+                if (!out)
+                {
+                    out.close();
+                    std::remove(temporary.c_str());
+                    throw std::runtime_error("Cannot write file: " + temporary);
+                }
+            }
+            if (std::rename(temporary.c_str(), path.c_str()) != 0)
+            {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("Cannot replace file: " + path);
+            }
+        }
+
+        /**
+         * @brief Validates the index section of a version 2 file and optionally decodes it.
+         * @param path The file name, for error messages.
+         * @param section The first byte after the payload.
+         * @param section_bytes Number of bytes from section to the end of the file.
+         * @param count Number of elements in the file.
+         * @param index Receives the decoded index (left empty when the file has none), or NULL to only validate.
+         * @returns void
+         * @throw std::runtime_error if the section is malformed or fails its checksum.
+         */
+        inline void readIndexSection(const std::string &path, const unsigned char *section, size_t section_bytes,
+                                     uint64_t count, SortedIndex *index)
+        {
+            IndexHeader index_header;
+            if (section_bytes < sizeof(index_header))
+            {
+                throw std::runtime_error("MyContainer file is truncated: " + path);
+            }
+            std::memcpy(&index_header, section, sizeof(index_header));
+            const uint64_t width = index_header.index_width;
+            const uint64_t stored_bytes = section_bytes - sizeof(index_header);
+            if (index_header.magic != IndexHeader::MAGIC ||
+                (width != 0 && width != sizeof(uint32_t) && width != sizeof(uint64_t)) ||
+                (width == 0 && (index_header.permutation_count != 0 || index_header.run_count != 0)) ||
+                (width != 0 && (index_header.permutation_count != count || index_header.run_count > count)))
+            {
+                throw std::runtime_error("MyContainer file has a malformed sorted index: " + path);
+            }
+            if (width != 0 && (stored_bytes / width < count + index_header.run_count ||
+                               stored_bytes != (count + index_header.run_count) * width))
+            {
+                throw std::runtime_error("MyContainer file is truncated or has trailing data: " + path);
+            }
+            if (width == 0 && stored_bytes != 0)
+            {
+                throw std::runtime_error("MyContainer file has trailing data: " + path);
+            }
+            const unsigned char *stored = section + sizeof(index_header);
+            PayloadChecksum checksum;
+            checksum.update(stored, static_cast<size_t>(stored_bytes));
+            if (checksum.value() != index_header.checksum)
+            {
+                throw std::runtime_error("MyContainer file sorted index checksum mismatch: " + path);
+            }
+            if (index == NULL || width == 0)
+            {
+                return;
+            }
+            decodeIndices(stored, static_cast<size_t>(count), static_cast<uint32_t>(width), index->permutation);
+            decodeIndices(stored + count * width, static_cast<size_t>(index_header.run_count), static_cast<uint32_t>(width),
+                          index->run_starts);
+        }
+
+        /**
+         * @brief Reads elements from a file in the MyContainer binary format through a memory mapping.
+         *
+         * @note The index is only checked for structure (sizes, bounds, checksum); the caller verifies that it
+         * actually orders the elements.
+         *
+         * @param path The file to read.
+         * @param out Receives the elements (unchanged if an exception is thrown).
+         * @param index Receives the stored sorted index (empty when the file has none), or NULL to skip it.
+         * @returns void
+         * @throw std::runtime_error if the file cannot be read, is not a MyContainer file of this element type,
+         *        is truncated or fails a checksum.
+         */
+        template <typename T>
+        void loadElements(const std::string &path, std::vector<T> &out, SortedIndex *index = NULL)
+        {
+            typedef ElementCodec<T> Codec;
+            MappedFile file(path);
+            FileHeader header;
+            if (file.size() < sizeof(header))
+            {
+                throw std::runtime_error("File too short for a MyContainer header: " + path);
+            }
+            std::memcpy(&header, file.data(), sizeof(header));
+            if (header.magic != FileHeader::MAGIC)
+            {
+                throw std::runtime_error("Not a MyContainer file: " + path);
+            }
+            if (header.version != 1 && header.version != FileHeader::VERSION)
+            {
+                throw std::runtime_error("Unsupported MyContainer file version: " + path);
+            }
+            if (header.payload_kind != Codec::PAYLOAD_KIND || header.element_size != Codec::ELEMENT_SIZE)
+            {
+                throw std::runtime_error("MyContainer file holds a different element type: " + path);
+            }
+            const size_t body_bytes = file.size() - sizeof(header);
+            const bool has_index_section = header.version >= 2;
+            if (has_index_section ? header.payload_bytes > body_bytes : header.payload_bytes != body_bytes)
+            {
+                throw std::runtime_error("MyContainer file is truncated or has trailing data: " + path);
+            }
+            const unsigned char *payload = file.data() + sizeof(header);
+            SortedIndex stored;
+            if (has_index_section)
+            {
+                readIndexSection(path, payload + header.payload_bytes, body_bytes - static_cast<size_t>(header.payload_bytes),
+                                 header.count, index != NULL ? &stored : NULL);
+            }
+            PayloadChecksum checksum;
+            checksum.update(payload, static_cast<size_t>(header.payload_bytes));
+            if (checksum.value() != header.checksum)
+            {
+                throw std::runtime_error("MyContainer file checksum mismatch: " + path);
+            }
+            std::vector<T> loaded;
+            if (!Codec::read(payload, header.payload_bytes, header.count, loaded))
+            {
+                throw std::runtime_error("MyContainer file payload does not match its header: " + path);
+            }
+            out.swap(loaded);
+            if (index != NULL)
+            {
+                index->permutation.swap(stored.permutation);
+                index->run_starts.swap(stored.run_starts);
+            }
+        }
+    }
+}
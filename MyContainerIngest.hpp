@@ -0,0 +1,390 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <algorithm>   // for std::max
+#include <cerrno>      // for errno
+#include <cstddef>     // for size_t
+#include <cstdlib>     // for std::strtold
+#include <cstring>     // for std::memcpy, std::memmove
+#include <exception>   // for std::exception_ptr
+#include <istream>     // for std::istream
+#include <iterator>    // for std::make_move_iterator
+#include <limits>      // for std::numeric_limits
+#include <sstream>     // for std::istringstream
+#include <stdexcept>   // for std::invalid_argument
+#include <string>      // for std::string
+#include <type_traits> // for std::true_type
+#include <vector>      // for std::vector
+#include "MyContainerThreadPool.hpp"
+
+namespace my_cont_ns
+{
+    namespace detail
+    {
+        // Bytes read from a stream per block by MyContainer::ingest()
+        static const size_t INGEST_BLOCK_SIZE = 1 << 16;
+
+        /**
+         * @brief Checks for the whitespace that separates tokens (the same set operator>> skips in the "C" locale).
+         * @param c The character.
+         * @returns true for space, tab, newline, vertical tab, form feed and carriage return.
+         * @throw None
+         */
+        inline bool isTokenSpace(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        /**
+         * @brief Throws the error of a token that cannot be parsed.
+         * @param begin First character of the token.
+         * @param end One past the last character of the token.
+         * @returns Never returns.
+         * @throw std::invalid_argument always.
+         */
+        [[noreturn]] inline void throwBadToken(const char *begin, const char *end)
+        {
+            throw std::invalid_argument("Cannot parse token: \"" + std::string(begin, end) + "\"");
+        }
+
+        /**
+         * @brief Parses a decimal integer token, rejecting trailing characters and out-of-range values.
+         * @param begin First character of the token.
+         * @param end One past the last character of the token.
+         * @returns The value.
+         * @throw std::invalid_argument if the token is not an integer that fits Integer.
+         */
+        template <typename Integer>
+        Integer parseInteger(const char *begin, const char *end)
+        {
+            const char *cursor = begin;
+            bool negative = false;
+            if (cursor != end && (*cursor == '-' || *cursor == '+'))
+            {
+                negative = *cursor == '-';
+                ++cursor;
+            }
+            if (cursor == end || (negative && !std::numeric_limits<Integer>::is_signed))
+            {
+                throwBadToken(begin, end);
+            }
+            // Accumulate the magnitude as unsigned and compare against the limit of the sign
+            const unsigned long long limit = negative
+                                                 ? static_cast<unsigned long long>(-(std::numeric_limits<Integer>::min() + 1)) + 1
+                                                 : static_cast<unsigned long long>(std::numeric_limits<Integer>::max());
+            unsigned long long magnitude = 0;
+            for (; cursor != end; ++cursor)
+            {
+                unsigned digit = static_cast<unsigned>(*cursor - '0');
+                if (digit > 9 || magnitude > (limit - digit) / 10)
+                {
+                    throwBadToken(begin, end); // Not a digit, or the value would exceed the limit
+                }
+                magnitude = magnitude * 10 + digit;
+            }
+            return negative ? static_cast<Integer>(0 - magnitude) : static_cast<Integer>(magnitude);
+        }
+
+        /**
+         * @brief Checks that a token is a plain decimal number: [sign] digits [. digits] [e [sign] digits].
+         * strtold also accepts "nan", "inf" and hex floats, which operator>> rejects.
+         * @param begin First character of the token.
+         * @param end One past the last character of the token.
+         * @returns true if the token has that form with at least one mantissa digit.
+         * @throw None
+         */
+        inline bool isDecimalFloating(const char *begin, const char *end)
+        {
+            const char *cursor = begin;
+            if (cursor != end && (*cursor == '-' || *cursor == '+'))
+            {
+                ++cursor;
+            }
+            size_t digits = 0;
+            for (; cursor != end && *cursor >= '0' && *cursor <= '9'; ++cursor)
+            {
+                ++digits;
+            }
+            if (cursor != end && *cursor == '.')
+            {
+                for (++cursor; cursor != end && *cursor >= '0' && *cursor <= '9'; ++cursor)
+                {
+                    ++digits;
+                }
+            }
+            if (digits == 0)
+            {
+                return false;
+            }
+            if (cursor != end && (*cursor == 'e' || *cursor == 'E'))
+            {
+                ++cursor;
+                if (cursor != end && (*cursor == '-' || *cursor == '+'))
+                {
+                    ++cursor;
+                }
+                const char *exponent = cursor;
+                for (; cursor != end && *cursor >= '0' && *cursor <= '9'; ++cursor)
+                {
+                }
+                if (cursor == exponent)
+                {
+                    return false;
+                }
+            }
+            return cursor == end;
+        }
+
+        /**
+         * @brief Parses a floating point token with the C library (exact rounding, same text as operator>> accepts).
+         * @param begin First character of the token.
+         * @param end One past the last character of the token.
+         * @returns The value.
+         * @throw std::invalid_argument if the token is not a number or is out of range.
+         */
+        template <typename Floating>
+        Floating parseFloating(const char *begin, const char *end)
+        {
+            char local[128];
+            size_t length = static_cast<size_t>(end - begin);
+            if (length >= sizeof(local) || !isDecimalFloating(begin, end))
+            {
+                throwBadToken(begin, end);
+            }
+            std::memcpy(local, begin, length);
+            local[length] = '\0'; // strtod needs a terminated string
+            char *stop = NULL;
+            errno = 0;
+            long double value = std::strtold(local, &stop);
+            if (stop != local + length || errno == ERANGE ||
+                value > std::numeric_limits<Floating>::max() || value < -std::numeric_limits<Floating>::max())
+            {
+                throwBadToken(begin, end);
+            }
+            return static_cast<Floating>(value);
+        }
+
+        // == Per-type token parsing, selected by overload ==
+
+        inline void parseToken(const char *begin, const char *end, short &out) { out = parseInteger<short>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, unsigned short &out) { out = parseInteger<unsigned short>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, int &out) { out = parseInteger<int>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, unsigned &out) { out = parseInteger<unsigned>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, long &out) { out = parseInteger<long>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, unsigned long &out) { out = parseInteger<unsigned long>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, long long &out) { out = parseInteger<long long>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, unsigned long long &out) { out = parseInteger<unsigned long long>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, float &out) { out = parseFloating<float>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, double &out) { out = parseFloating<double>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, long double &out) { out = parseFloating<long double>(begin, end); }
+
+        inline void parseToken(const char *begin, const char *end, std::string &out) { out.assign(begin, end); }
+
+        /**
+         * @brief Fallback for every other type: the token goes through T's operator>>, which must consume all of it.
+         * @param begin First character of the token.
+         * @param end One past the last character of the token.
+         * @param out Receives the value.
+         * @returns void
+         * @throw std::invalid_argument if operator>> fails or leaves characters behind.
+         */
+        template <typename T>
+        void parseToken(const char *begin, const char *end, T &out)
+        {
+            std::istringstream token(std::string(begin, end));
+            if (!(token >> out) || token.peek() != std::char_traits<char>::eof())
+            {
+                throwBadToken(begin, end);
+            }
+        }
+
+        /**
+         * @brief true for the character types, where every non-whitespace character is one element (as with operator>>).
+         */
+        template <typename T> struct IsCharElement : std::false_type {};
+        template <> struct IsCharElement<char> : std::true_type {};
+        template <> struct IsCharElement<signed char> : std::true_type {};
+        template <> struct IsCharElement<unsigned char> : std::true_type {};
+
+        /**
+         * @brief Parses every whitespace-separated token of a text range and appends the values.
+         * @param begin First character of the text.
+         * @param end One past the last character of the text.
+         * @param out Receives the values.
+         * @returns void
+         * @throw std::invalid_argument if a token cannot be parsed.
+         */
+        template <typename T>
+        void parseRange(const char *begin, const char *end, std::vector<T> &out, std::false_type)
+        {
+            const char *cursor = begin;
+            while (true)
+            {
+                while (cursor != end && isTokenSpace(*cursor))
+                {
+                    ++cursor;
+                }
+                if (cursor == end)
+                {
+                    return;
+                }
+                const char *token = cursor;
+                while (cursor != end && !isTokenSpace(*cursor))
+                {
+                    ++cursor;
+                }
+                T value;
+                parseToken(token, cursor, value);
+                out.push_back(value);
+            }
+        }
+
+        /**
+         * @brief Appends every non-whitespace character of a text range (character element types).
+         * @param begin First character of the text.
+         * @param end One past the last character of the text.
+         * @param out Receives the characters.
+         * @returns void
+         * @throw None
+         */
+        template <typename T>
+        void parseRange(const char *begin, const char *end, std::vector<T> &out, std::true_type)
+        {
+            for (const char *cursor = begin; cursor != end; ++cursor)
+            {
+                if (!isTokenSpace(*cursor))
+                {
+                    out.push_back(static_cast<T>(*cursor));
+                }
+            }
+        }
+
+        /**
+         * @brief Parses every token of a text range and appends the values.
+         * @param begin First character of the text.
+         * @param end One past the last character of the text.
+         * @param out Receives the values.
+         * @returns void
+         * @throw std::invalid_argument if a token cannot be parsed.
+         */
+        template <typename T>
+        void parseRange(const char *begin, const char *end, std::vector<T> &out)
+        {
+            parseRange(begin, end, out, IsCharElement<T>());
+        }
+
+        /**
+         * @brief Reads a stream in large blocks and appends the value of every token.
+         * A token cut by the end of a block is carried over to the next block.
+         * @param in The stream to read until its end.
+         * @param out Receives the values.
+         * @returns void
+         * @throw std::invalid_argument if a token cannot be parsed.
+         */
+        template <typename T>
+        void ingestStream(std::istream &in, std::vector<T> &out)
+        {
+            std::vector<char> block(INGEST_BLOCK_SIZE);
+            size_t carried = 0; // Characters of an unfinished token at the start of block
+            while (in)
+            {
+                if (carried == block.size())
+                {
+                    block.resize(block.size() * 2); // A single token longer than the block
+                }
+                in.read(block.data() + carried, static_cast<std::streamsize>(block.size() - carried));
+                size_t filled = carried + static_cast<size_t>(in.gcount());
+                if (filled == carried)
+                {
+                    break;
+                }
+                // Parse up to the last whitespace, the rest may continue in the next block
+                size_t complete = filled;
+                if (in)
+                {
+                    while (complete != 0 && !isTokenSpace(block[complete - 1]))
+                    {
+                        --complete;
+                    }
+                }
+                parseRange(block.data(), block.data() + complete, out);
+                carried = filled - complete;
+                std::memmove(block.data(), block.data() + complete, carried);
+            }
+            parseRange(block.data(), block.data() + carried, out);
+        }
+
+        /**
+         * @brief Parses a text range on several threads and appends the values in text order.
+         * The range is cut into one piece per thread, each cut moved forward to the next whitespace so that no
+         * token is split; the pieces are parsed on ThreadPool::instance(), each into its own vector.
+         * @param begin First character of the text.
+         * @param end One past the last character of the text.
+         * @param threads Number of threads (at least 1).
+         * @param out Receives the values.
+         * @returns void
+         * @throw std::invalid_argument if a token cannot be parsed (the first failing piece is reported).
+         */
+        template <typename T>
+        void parseRangeParallel(const char *begin, const char *end, unsigned threads, std::vector<T> &out)
+        {
+            const size_t length = static_cast<size_t>(end - begin);
+            if (threads <= 1 || length < threads * size_t(4096))
+            {
+                parseRange(begin, end, out); // Not worth the threads
+                return;
+            }
+            std::vector<const char *> cuts(threads + 1, end);
+            cuts[0] = begin;
+            for (unsigned piece = 1; piece < threads; ++piece)
+            {
+                const char *cut = std::max(cuts[piece - 1], begin + length / threads * piece);
+                while (cut != end && !isTokenSpace(*cut))
+                {
+                    ++cut;
+                }
+                cuts[piece] = cut;
+            }
+
+            std::vector<std::vector<T>> parts(threads);
+            std::vector<std::exception_ptr> errors(threads);
+            ThreadPool::instance().parallelFor(0, threads, 1, [&](size_t first, size_t last)
+                                               {
+                                                   for (size_t piece = first; piece < last; ++piece)
+                                                   {
+                                                       try
+                                                       {
+                                                           parseRange(cuts[piece], cuts[piece + 1], parts[piece]);
+                                                       }
+                                                       catch (...)
+                                                       {
+                                                           errors[piece] = std::current_exception(); // Reported in text order below
+                                                       }
+                                                   } });
+            size_t total = 0;
+            for (unsigned piece = 0; piece < threads; ++piece)
+            {
+                if (errors[piece])
+                {
+                    std::rethrow_exception(errors[piece]);
+                }
+                total += parts[piece].size();
+            }
+            out.reserve(out.size() + total);
+            for (unsigned piece = 0; piece < threads; ++piece)
+            {
+                out.insert(out.end(), std::make_move_iterator(parts[piece].begin()), std::make_move_iterator(parts[piece].end()));
+            }
+        }
+    }
+}
@@ -0,0 +1,447 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <algorithm>   // for std::find, std::remove
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint32_t, uint64_t
+#include <functional>  // for std::less, std::greater
+#include <stdexcept>   // for std::runtime_error, std::invalid_argument
+#include <string>      // for std::string
+#include <type_traits> // for std::is_trivially_copyable
+#include <fcntl.h>     // for ::open
+#include <sys/mman.h>  // for ::mmap, ::mremap, ::msync
+#include <sys/stat.h>  // for ::fstat
+#include <unistd.h>    // for ::ftruncate, ::close
+#include "MyContainerView.hpp"
+
+namespace my_cont_ns
+{
+    namespace detail
+    {
+        /**
+         * @brief Growable array of trivially copyable elements kept in a memory-mapped file.
+         * The file starts with a small header (magic, element size, element count) followed by the elements.
+         * Growing doubles the capacity with ftruncate and remaps with mremap, so the elements are paged in and
+         * out by the kernel and the array can be far larger than RAM.
+         */
+        template <typename T>
+        class MappedVector
+        {
+        private:
+            static_assert(std::is_trivially_copyable<T>::value, "MappedVector stores raw elements and requires a trivially copyable type");
+
+            struct Header
+            {
+                uint32_t magic;
+                uint32_t element_size;
+                uint64_t count;
+                unsigned char padding[48]; // Keeps the elements 64-byte aligned
+            };
+
+            static const uint32_t MAGIC = 0x4d43594d; // "MYCM"
+            static const size_t INITIAL_CAPACITY = 4096;
+
+            std::string path;
+            int fd;
+            unsigned char *mapping; // Header followed by capacity elements
+            size_t capacity;
+
+            MappedVector(const MappedVector &);
+            MappedVector &operator=(const MappedVector &);
+
+            Header &header() const { return *reinterpret_cast<Header *>(mapping); }
+
+            static size_t bytesFor(size_t elements) { return sizeof(Header) + elements * sizeof(T); }
+
+            /**
+             * @brief Resizes the file and its mapping to hold a new capacity.
+             * @param new_capacity Number of elements the file must hold.
+             * @returns void
+             * @throw std::runtime_error if the file cannot be resized or remapped.
+             */
+            void reserveExactly(size_t new_capacity)
+            {
+                const size_t old_bytes = bytesFor(capacity);
+                const size_t new_bytes = bytesFor(new_capacity);
+                if (::ftruncate(fd, static_cast<off_t>(new_bytes)) != 0)
+                {
+                    throw std::runtime_error("Cannot grow file: " + path);
+                }
+#ifdef __linux__
+                void *moved = ::mremap(mapping, old_bytes, new_bytes, MREMAP_MAYMOVE);
+#else
+                // Map the grown file before unmapping the old view, so a failure leaves the old mapping usable
+                void *moved = ::mmap(NULL, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+#endif
+                if (moved == MAP_FAILED)
+                {
+                    throw std::runtime_error("Cannot remap file: " + path);
+                }
+#ifndef __linux__
+                ::munmap(mapping, old_bytes);
+#endif
+                mapping = static_cast<unsigned char *>(moved);
+                capacity = new_capacity;
+            }
+
+        public:
+            /**
+             * @brief Opens a file-backed array, creating the file if it does not exist.
+             * @param file_path The backing file.
+             * @returns MappedVector object holding the elements already in the file.
+             * @throw std::runtime_error if the file cannot be opened or mapped, or holds another element type.
+             */
+            explicit MappedVector(const std::string &file_path) : path(file_path), fd(-1), mapping(NULL), capacity(0)
+            {
+                fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+                if (fd < 0)
+                {
+                    throw std::runtime_error("Cannot open file: " + path);
+                }
+                struct stat info;
+                if (::fstat(fd, &info) != 0)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot stat file: " + path);
+                }
+                const size_t existing = static_cast<size_t>(info.st_size);
+                const bool created = existing == 0;
+                if (!created && existing < sizeof(Header))
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Not a MappedVector file: " + path);
+                }
+                size_t bytes = created ? bytesFor(INITIAL_CAPACITY) : existing;
+                if (created && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot grow file: " + path);
+                }
+                void *mapped = ::mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (mapped == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot map file: " + path);
+                }
+                mapping = static_cast<unsigned char *>(mapped);
+                capacity = (bytes - sizeof(Header)) / sizeof(T);
+                if (created)
+                {
+                    header().magic = MAGIC;
+                    header().element_size = sizeof(T);
+                    header().count = 0;
+                }
+                else if (header().magic != MAGIC || header().element_size != sizeof(T) || header().count > capacity)
+                {
+                    ::munmap(mapping, bytes);
+                    ::close(fd);
+                    throw std::runtime_error("File holds another element type or is corrupted: " + path);
+                }
+            }
+
+            /**
+             * @brief Destructor, trims the file to the stored elements and unmaps it.
+             * @param None
+             * @returns None
+             * @throw None
+             */
+            ~MappedVector()
+            {
+                const size_t used = bytesFor(size());
+                ::munmap(mapping, bytesFor(capacity));
+                if (::ftruncate(fd, static_cast<off_t>(used)) != 0)
+                {
+                    // The file keeps its spare capacity, which the next open simply reuses
+                }
+                ::close(fd);
+            }
+
+            /**
+             * @brief Returns the number of stored elements.
+             * @param None
+             * @returns The size of the array.
+             * @throw None
+             */
+            size_t size() const { return static_cast<size_t>(header().count); }
+
+            /**
+             * @brief Returns the stored elements.
+             * @param None
+             * @returns Pointer to the first element, invalidated by push_back().
+             * @throw None
+             */
+            T *data() const { return reinterpret_cast<T *>(mapping + sizeof(Header)); }
+
+            /**
+             * @brief Appends an element, doubling the file when it is full.
+             * @param element The element to append.
+             * @returns void
+             * @throw std::runtime_error if the file cannot be grown.
+             */
+            void push_back(const T &element)
+            {
+                if (size() == capacity)
+                {
+                    reserveExactly(capacity < INITIAL_CAPACITY / 2 ? INITIAL_CAPACITY : capacity * 2);
+                }
+                data()[size()] = element;
+                header().count += 1;
+            }
+
+            /**
+             * @brief Drops the elements from a position to the end.
+             * @param new_size Number of elements to keep, at most size().
+             * @returns void
+             * @throw None
+             */
+            void truncate(size_t new_size) { header().count = new_size; }
+
+            /**
+             * @brief Writes the modified pages back to the file and waits for the writes.
+             * @param None
+             * @returns void
+             * @throw std::runtime_error if the write-back fails.
+             */
+            void sync() const
+            {
+                if (::msync(mapping, bytesFor(size()), MS_SYNC) != 0)
+                {
+                    throw std::runtime_error("Cannot sync file: " + path);
+                }
+            }
+        };
+    }
+
+    /**
+     * @brief ExternalSideCrossOrder Iterator Class
+     * Traverses elements in side-cross order (smallest, largest, second smallest, ...) through two
+     * external-memory sorts, one ascending and one descending, that each get half of the memory budget and
+     * are streamed alternately.
+     *
+     * @note Single pass like ExternalSortedOrder: every copy shares the read positions. Requires a trivially
+     * copyable T.
+     */
+    template <typename T>
+    class ExternalSideCrossOrder
+    {
+    private:
+        ExternalSortedOrder<T, std::less<T>> ascending;     // Yields the even positions
+        ExternalSortedOrder<T, std::greater<T>> descending; // Yields the odd positions
+        size_t total;
+        size_t current_index;
+
+    public:
+        /**
+         * @brief Constructor for the ExternalSideCrossOrder iterator.
+         * @param data The elements to order, read run by run.
+         * @param count Number of elements.
+         * @param memory_budget Bytes available for element buffers, split between the two sorts.
+         * @param temp_directory Directory for the spill files; empty to use $TMPDIR, or /tmp if it is not set.
+         * @returns ExternalSideCrossOrder object.
+         * @throw std::invalid_argument if half the budget cannot hold 3 elements.
+         * @throw std::runtime_error if a spill file cannot be created, written or read.
+         */
+        ExternalSideCrossOrder(const T *data, size_t count, size_t memory_budget, const std::string &temp_directory)
+            : ascending(data, count, memory_budget / 2, temp_directory),
+              descending(data, count, memory_budget / 2, temp_directory), total(count), current_index(0) {}
+
+        /**
+         * @brief Pre-increment operator for the ExternalSideCrossOrder iterator.
+         * @param None
+         * @returns Reference to the current ExternalSideCrossOrder object after incrementing.
+         * @throw std::runtime_error if a spill file cannot be read.
+         */
+        ExternalSideCrossOrder &operator++()
+        {
+            if (current_index < total)
+            {
+                if (current_index % 2 == 0)
+                {
+                    ++ascending;
+                }
+                else
+                {
+                    ++descending;
+                }
+            }
+            ++current_index;
+            return *this;
+        }
+
+        /**
+         * @brief Post-increment operator for the ExternalSideCrossOrder iterator.
+         *
+         * @note The returned copy shares the read positions, dereferencing it yields the new current element.
+         *
+         * @param None
+         * @returns A copy of the ExternalSideCrossOrder object before incrementing.
+         * @throw std::runtime_error if a spill file cannot be read.
+         */
+        ExternalSideCrossOrder operator++(int)
+        {
+            ExternalSideCrossOrder temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        /**
+         * @brief Dereference operator for the ExternalSideCrossOrder iterator.
+         * @param None
+         * @returns A constant reference to the current element, valid until the iterator advances.
+         * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+         */
+        const T &operator*() const
+        {
+            detail::checkIteratorIndex(current_index, total);
+            return current_index % 2 == 0 ? *ascending : *descending;
+        }
+
+        bool operator==(const ExternalSideCrossOrder &other) const { return current_index == other.current_index; }
+
+        bool operator!=(const ExternalSideCrossOrder &other) const { return !(*this == other); }
+
+        /**
+         * @brief Begin method for the ExternalSideCrossOrder iterator.
+         * @param None
+         * @returns A copy of this iterator (the order is single pass and cannot be rewound).
+         * @throw None
+         */
+        ExternalSideCrossOrder begin() { return *this; }
+
+        /**
+         * @brief End method for the ExternalSideCrossOrder iterator.
+         * @param None
+         * @returns A new ExternalSideCrossOrder iterator pointing to one past the last element.
+         * @throw None
+         */
+        ExternalSideCrossOrder end()
+        {
+            ExternalSideCrossOrder iter = *this;
+            iter.current_index = total;
+            return iter;
+        }
+    };
+
+    /**
+     * @brief Container with the add/remove/iterate interface of MyContainer whose elements live in a
+     * memory-mapped file instead of a std::vector, for datasets larger than RAM.
+     * Order, ReverseOrder and MiddleOutOrder read the mapping in place through the page cache; the sorted
+     * orders and SideCrossOrder go through the external-memory sort, so no step needs the dataset in memory.
+     *
+     * @note The elements persist in the file: opening it again restores them. Iterators are invalidated by
+     * add() and remove(). Requires a trivially copyable T.
+     */
+    template <typename T = int>
+    class MappedContainer
+    {
+    private:
+        detail::MappedVector<T> elements;
+
+    public:
+        // Default memory budget of the sorted orders
+        static const size_t DEFAULT_SORT_BUDGET = size_t(64) << 20;
+
+        typedef typename MyContainerView<T>::Order Order;
+        typedef typename MyContainerView<T>::ReverseOrder ReverseOrder;
+        typedef typename MyContainerView<T>::MiddleOutOrder MiddleOutOrder;
+        typedef ExternalSortedOrder<T, std::less<T>> AscendingOrder;
+        typedef ExternalSortedOrder<T, std::greater<T>> DescendingOrder;
+        typedef ExternalSideCrossOrder<T> SideCrossOrder;
+
+        /**
+         * @brief Constructor for MappedContainer.
+         * @param path The backing file, created if it does not exist.
+         * @returns MappedContainer object holding the elements already in the file.
+         * @throw std::runtime_error if the file cannot be opened or mapped, or holds another element type.
+         */
+        explicit MappedContainer(const std::string &path) : elements(path) {}
+
+        /**
+         * @brief Returns the number of elements in the container.
+         * @param None
+         * @returns The size of the container.
+         * @throw None
+         */
+        size_t size() const { return elements.size(); }
+
+        /**
+         * @brief Checks if the container is empty.
+         * @param None
+         * @returns true if the container has no elements, false otherwise.
+         * @throw None
+         */
+        bool isEmpty() const { return elements.size() == 0; }
+
+        /**
+         * @brief Adds an element to the container.
+         * @param element The element to add to the container.
+         * @returns void
+         * @throw std::runtime_error if the backing file cannot be grown.
+         */
+        void add(const T &element)
+        {
+            elements.push_back(element);
+        }
+
+        /**
+         * @brief Removes all occurrences of the specified element from the container.
+         * @param element The element to remove from the container.
+         * @returns void
+         * @throw std::invalid_argument if the element is not found.
+         */
+        void remove(const T &element)
+        {
+            MYCONTAINER_TRACE_SCOPE("remove", elements.size());
+            T *first = elements.data();
+            T *last = first + elements.size();
+            if (std::find(first, last, element) == last)
+            {
+                throw std::invalid_argument("Element not found in container");
+            }
+            elements.truncate(static_cast<size_t>(std::remove(first, last, element) - first));
+        }
+
+        /**
+         * @brief Writes the elements back to the file and waits for the writes.
+         * @param None
+         * @returns void
+         * @throw std::runtime_error if the write-back fails.
+         */
+        void sync() const { elements.sync(); }
+
+        /**
+         * @brief Returns a read-only view of the elements.
+         * @param None
+         * @returns View over the mapping, invalidated by add() and remove().
+         * @throw None
+         */
+        MyContainerView<T> view() const { return MyContainerView<T>(elements.data(), elements.size()); }
+
+        // Factory methods to create iterators:
+        Order getOrder() const { return view().getOrder(); }
+
+        ReverseOrder getReverseOrder() const { return view().getReverseOrder(); }
+
+        MiddleOutOrder getMiddleOutOrder() const { return view().getMiddleOutOrder(); }
+
+        /**
+         * @brief Sorted and side-cross iterators, served by the external-memory sort (see ExternalSortedOrder).
+         * At most memory_budget bytes of element buffers are used; sorted runs are spilled under
+         * temp_directory ($TMPDIR or /tmp when empty).
+         */
+        AscendingOrder getAscendingOrder(size_t memory_budget = DEFAULT_SORT_BUDGET, const std::string &temp_directory = "") const
+        {
+            return AscendingOrder(elements.data(), elements.size(), memory_budget, temp_directory);
+        }
+
+        DescendingOrder getDescendingOrder(size_t memory_budget = DEFAULT_SORT_BUDGET, const std::string &temp_directory = "") const
+        {
+            return DescendingOrder(elements.data(), elements.size(), memory_budget, temp_directory);
+        }
+
+        SideCrossOrder getSideCrossOrder(size_t memory_budget = DEFAULT_SORT_BUDGET, const std::string &temp_directory = "") const
+        {
+            return SideCrossOrder(elements.data(), elements.size(), memory_budget, temp_directory);
+        }
+    };
+}
@@ -0,0 +1,100 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <algorithm> // for std::min
+#include <cstddef>   // for size_t
+#include <deque>     // for std::deque
+#include "MyContainerThreadPool.hpp"
+
+namespace my_cont_ns
+{
+    // Default minimum number of positions per chunk of parallelForEach() and parallelReduce()
+    static const size_t DEFAULT_PARALLEL_GRAIN = 1024;
+
+    /**
+     * @brief Calls fn on every element of an order, with the order's positions split into chunks that run in
+     * parallel on a thread pool.
+     * Works with every order that maps a position to an element in O(1) (size() and at()), i.e. the six
+     * orders of MyContainer. A lazily produced order is completed first, so the threads only read it.
+     *
+     * @note fn runs concurrently on different elements and in no particular order; it must not modify the
+     * container the order was taken from.
+     *
+     * @param order The order to traverse.
+     * @param fn Callable invoked as fn(const T &) once per element.
+     * @param grain Minimum number of positions per chunk (0 is treated as 1).
+     * @param pool The pool that runs the chunks.
+     * @returns void
+     * @throw The first exception thrown by fn, after every chunk finished.
+     */
+    template <typename Order, typename Function>
+    void parallelForEach(const Order &order, Function fn, size_t grain = DEFAULT_PARALLEL_GRAIN,
+                         ThreadPool &pool = ThreadPool::instance())
+    {
+        const size_t count = order.size();
+        if (count == 0)
+        {
+            return;
+        }
+        order.at(count - 1); // Completes a lazy order before it is read concurrently
+        pool.parallelFor(0, count, grain, [&order, &fn](size_t first, size_t last)
+                         {
+                             for (size_t position = first; position < last; ++position)
+                             {
+                                 fn(order.at(position));
+                             } });
+    }
+
+    /**
+     * @brief Folds the elements of an order into one result, with the order's positions split into chunks
+     * that are folded in parallel on a thread pool.
+     * Every chunk starts from identity and folds its elements in traversal order; the chunk results are then
+     * combined in traversal order too, so combine only needs to be associative, not commutative.
+     *
+     * @note As with parallelForEach(), accumulate runs concurrently on different chunks.
+     *
+     * @param order The order to fold.
+     * @param identity The result of an empty order, and the starting value of every chunk.
+     * @param accumulate Callable invoked as accumulate(Result, const T &) -> Result.
+     * @param combine Callable invoked as combine(Result, Result) -> Result, with the earlier chunk first.
+     * @param grain Minimum number of positions per chunk (0 is treated as 1).
+     * @param pool The pool that runs the chunks.
+     * @returns The combined result of every chunk.
+     * @throw The first exception thrown by accumulate, after every chunk finished, or by combine.
+     */
+    template <typename Order, typename Result, typename Accumulate, typename Combine>
+    Result parallelReduce(const Order &order, Result identity, Accumulate accumulate, Combine combine,
+                          size_t grain = DEFAULT_PARALLEL_GRAIN, ThreadPool &pool = ThreadPool::instance())
+    {
+        const size_t count = order.size();
+        if (count == 0)
+        {
+            return identity;
+        }
+        order.at(count - 1); // Completes a lazy order before it is read concurrently
+        grain = grain == 0 ? 1 : grain;
+        // A few chunks per thread as in ThreadPool::parallelFor(), cut here so that each has its own result slot
+        size_t chunks = (count + grain - 1) / grain;
+        chunks = chunks < 4 * (pool.workerCount() + 1) ? chunks : 4 * (pool.workerCount() + 1);
+        const size_t chunk_size = (count + chunks - 1) / chunks;
+        std::deque<Result> partial(chunks, identity); // Not std::vector, whose bool specialization shares bytes between slots
+        pool.parallelFor(0, chunks, 1, [&](size_t first_chunk, size_t last_chunk)
+                         {
+                             for (size_t chunk = first_chunk; chunk < last_chunk; ++chunk)
+                             {
+                                 const size_t last = std::min(count, (chunk + 1) * chunk_size);
+                                 Result result = identity;
+                                 for (size_t position = chunk * chunk_size; position < last; ++position)
+                                 {
+                                     result = accumulate(result, order.at(position));
+                                 }
+                                 partial[chunk] = result;
+                             } });
+        Result total = identity;
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            total = combine(total, partial[chunk]);
+        }
+        return total;
+    }
+}
@@ -0,0 +1,658 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <algorithm>  // for std::push_heap, std::pop_heap, std::lower_bound, std::upper_bound
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <functional> // for std::hash
+#include <stdexcept>  // for std::invalid_argument
+#include <vector>     // for std::vector
+#include "MyContainer.hpp"
+#include "MyContainerThreadPool.hpp"
+
+namespace my_cont_ns
+{
+    /**
+     * @brief Container that hash-partitions its elements across several MyContainer shards.
+     * All occurrences of a value live in the same shard, so remove() and count() scan one shard instead of
+     * every element, and bulk operations and sort-cache builds run on all shards in parallel (on ThreadPool::instance()).
+     * All six orders of MyContainer are available as lazy iterators: the sorted orders (and side-cross) are a
+     * k-way merge of the shards' sort caches, and the insertion-based orders (order, reverse, middle-out) are a
+     * k-way merge on a global sequence number that every element carries.
+     *
+     * @note Like MyContainer, a ShardedMyContainer must not be modified from several threads at once.
+     * The insertion-based iterators read the shards in place, so they are invalidated by add() and remove().
+     * @tparam T Element type.
+     * @tparam Hash Hash function that picks the shard of a value.
+     */
+    template <typename T = int, typename Hash = std::hash<T>>
+    class ShardedMyContainer
+    {
+    private:
+        std::vector<MyContainer<T>> shards;
+        std::vector<std::vector<uint64_t>> sequences; // sequences[s][i]: insertion number of shards[s] element i
+        uint64_t next_sequence;
+        Hash hash;
+
+        /**
+         * @brief Returns the shard that owns a value.
+         * @param element The value.
+         * @returns Index of the shard.
+         * @throw None
+         */
+        size_t shardOf(const T &element) const
+        {
+            return static_cast<size_t>(hash(element) % shards.size());
+        }
+
+        /**
+         * @brief Runs a function for every shard in parallel on ThreadPool::instance().
+         * @param fn Callable invoked as fn(size_t shard).
+         * @returns void
+         * @throw The first exception thrown by fn, after every shard finished.
+         */
+        template <typename Function>
+        void forEachShardParallel(Function fn) const
+        {
+            ThreadPool::instance().parallelFor(0, shards.size(), 1, [&fn](size_t first, size_t last)
+                                               {
+                                                   for (size_t s = first; s < last; ++s)
+                                                   {
+                                                       fn(s);
+                                                   } });
+        }
+
+    public:
+        /**
+         * @brief Constructor for ShardedMyContainer.
+         * @param shard_count Number of shards (e.g. the number of cores).
+         * @param hasher Hash function that picks the shard of a value.
+         * @returns ShardedMyContainer object, empty.
+         * @throw std::invalid_argument if shard_count is 0.
+         */
+        explicit ShardedMyContainer(size_t shard_count, const Hash &hasher = Hash())
+            : next_sequence(0), hash(hasher)
+        {
+            if (shard_count == 0)
+            {
+                throw std::invalid_argument("A sharded container needs at least one shard");
+            }
+            shards.resize(shard_count);
+            sequences.resize(shard_count);
+        }
+
+        /**
+         * @brief Returns the number of elements in the container.
+         * @param None
+         * @returns The sum of the shard sizes.
+         * @throw None
+         */
+        size_t size() const
+        {
+            size_t total = 0;
+            for (size_t s = 0; s < shards.size(); ++s)
+            {
+                total += shards[s].size();
+            }
+            return total;
+        }
+
+        /**
+         * @brief Checks if the container is empty.
+         * @param None
+         * @returns true if the container has no elements, false otherwise.
+         * @throw None
+         */
+        bool isEmpty() const { return size() == 0; }
+
+        /**
+         * @brief Returns the number of shards.
+         * @param None
+         * @returns The shard count given at construction.
+         * @throw None
+         */
+        size_t shardCount() const { return shards.size(); }
+
+        /**
+         * @brief Returns one shard.
+         * @param index Index of the shard, smaller than shardCount().
+         * @returns A constant reference to the shard.
+         * @throw std::out_of_range if index is not a shard.
+         */
+        const MyContainer<T> &shard(size_t index) const { return shards.at(index); }
+
+        /**
+         * @brief Adds an element to the shard that owns it.
+         * @param element The element to add to the container.
+         * @returns void
+         * @throw Whatever copying the element or growing the shard throws; the container is then unchanged.
+         */
+        void add(const T &element)
+        {
+            size_t s = shardOf(element);
+            sequences[s].push_back(next_sequence);
+            try
+            {
+                shards[s].add(element);
+            }
+            catch (...)
+            {
+                sequences[s].pop_back();
+                throw;
+            }
+            ++next_sequence;
+        }
+
+        /**
+         * @brief Adds many elements, in order, appending to all shards in parallel.
+         * @param batch The elements to add.
+         * @returns void
+         * @throw The first exception thrown by copying an element or growing a shard, after every shard
+         * finished; the shards are then truncated back, so the container is unchanged.
+         */
+        void addAll(const std::vector<T> &batch)
+        {
+            // Partition first, so that every thread only touches its own shard
+            std::vector<std::vector<size_t>> owned(shards.size());
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                owned[shardOf(batch[i])].push_back(i);
+            }
+            std::vector<size_t> before(shards.size());
+            for (size_t s = 0; s < shards.size(); ++s)
+            {
+                before[s] = sequences[s].size();
+            }
+            const uint64_t first_sequence = next_sequence;
+            std::vector<MyContainer<T>> &shard_list = shards;
+            std::vector<std::vector<uint64_t>> &sequence_list = sequences;
+            try
+            {
+                forEachShardParallel([&](size_t s)
+                                     {
+                                         for (size_t i : owned[s])
+                                         {
+                                             shard_list[s].add(batch[i]);
+                                             sequence_list[s].push_back(first_sequence + i);
+                                         } });
+            }
+            catch (...)
+            {
+                // Shards and sequence numbers may have stopped at different lengths; cut both back
+                for (size_t s = 0; s < shards.size(); ++s)
+                {
+                    shards[s].truncate(before[s]);
+                    sequences[s].resize(before[s]);
+                }
+                throw;
+            }
+            next_sequence += batch.size();
+        }
+
+        /**
+         * @brief Removes all occurrences of the specified element, scanning only the shard that owns it.
+         * @param element The element to remove from the container.
+         * @returns void
+         * @throw std::invalid_argument if the element is not found.
+         */
+        void remove(const T &element)
+        {
+            size_t s = shardOf(element);
+            const std::vector<T> &owned = shards[s].getElements();
+            std::vector<uint64_t> &numbers = sequences[s];
+            size_t kept = 0;
+            for (size_t i = 0; i < owned.size(); ++i)
+            {
+                if (!(owned[i] == element))
+                {
+                    numbers[kept++] = numbers[i];
+                }
+            }
+            if (kept == owned.size())
+            {
+                throw std::invalid_argument("Element not found in container");
+            }
+            numbers.resize(kept);
+            shards[s].remove(element);
+        }
+
+        /**
+         * @brief Counts the occurrences of an element, scanning only the shard that owns it.
+         * @param element The element to count.
+         * @returns Number of elements equal to element.
+         * @throw None
+         */
+        size_t count(const T &element) const
+        {
+            return shards[shardOf(element)].count(element);
+        }
+
+        /**
+         * @brief Builds the sort cache of every stale shard, all shards in parallel.
+         * getAscendingOrder() and getDescendingOrder() call this, so the merge starts from warm caches.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void prepareSorted() const
+        {
+            const std::vector<MyContainer<T>> &shard_list = shards;
+            forEachShardParallel([&shard_list](size_t s)
+                                 { shard_list[s].sortedElements(); });
+        }
+
+    private:
+        /**
+         * @brief Counts the elements whose sequence number is at most a bound.
+         * @param bound The largest sequence number to count.
+         * @returns The number of elements added no later than the element numbered bound.
+         * @throw None
+         */
+        size_t countUpTo(uint64_t bound) const
+        {
+            size_t counted = 0;
+            for (size_t s = 0; s < shards.size(); ++s)
+            {
+                counted += std::upper_bound(sequences[s].begin(), sequences[s].end(), bound) - sequences[s].begin();
+            }
+            return counted;
+        }
+
+        /**
+         * @brief Splits every shard before the element of a given rank in insertion order.
+         * Binary-searches the sequence number of that element, O(k log n log next_sequence).
+         * @param rank Position in insertion order; size() splits after every element.
+         * @returns For every shard, the number of its elements that come before rank.
+         * @throw None
+         */
+        std::vector<size_t> splitAt(size_t rank) const
+        {
+            std::vector<size_t> before(shards.size());
+            if (rank >= size())
+            {
+                for (size_t s = 0; s < shards.size(); ++s)
+                {
+                    before[s] = sequences[s].size();
+                }
+                return before;
+            }
+            uint64_t low = 0;
+            uint64_t high = next_sequence - 1;
+            while (low < high) // Smallest number with more than rank elements at or below it
+            {
+                uint64_t middle = low + (high - low) / 2;
+                if (countUpTo(middle) > rank)
+                {
+                    high = middle;
+                }
+                else
+                {
+                    low = middle + 1;
+                }
+            }
+            for (size_t s = 0; s < shards.size(); ++s)
+            {
+                before[s] = std::lower_bound(sequences[s].begin(), sequences[s].end(), low) - sequences[s].begin();
+            }
+            return before;
+        }
+
+        /**
+         * @brief One direction of the k-way merge on sequence numbers, from a split point.
+         * A heap of the shards that still have elements in the walk's direction yields the next element in O(log k).
+         */
+        class SequenceWalk
+        {
+        private:
+            const ShardedMyContainer *owner;
+            bool backward;              // Walk towards the first insertion
+            std::vector<size_t> cursor; // Forward: next element of each shard; backward: one past it
+            std::vector<size_t> heap;   // Shards with an element left, the next one at the front
+
+            bool hasNext(size_t s) const
+            {
+                return backward ? cursor[s] > 0 : cursor[s] < owner->sequences[s].size();
+            }
+
+            size_t nextIndex(size_t s) const { return backward ? cursor[s] - 1 : cursor[s]; }
+
+            /**
+             * @brief Heap order: checks if a shard's next element comes after another shard's next element.
+             * @param a Index of a shard with an element left.
+             * @param b Index of another such shard.
+             * @returns true if a comes later in the walk.
+             * @throw None
+             */
+            bool later(size_t a, size_t b) const
+            {
+                uint64_t sequence_a = owner->sequences[a][nextIndex(a)];
+                uint64_t sequence_b = owner->sequences[b][nextIndex(b)];
+                return backward ? sequence_a < sequence_b : sequence_a > sequence_b;
+            }
+
+        public:
+            SequenceWalk() : owner(NULL), backward(false) {}
+
+            /**
+             * @brief Constructor for SequenceWalk.
+             * @param container The container to walk.
+             * @param towards_first true to walk towards the first insertion.
+             * @param split The result of splitAt(): forward walks start at it, backward walks just before it.
+             * @returns SequenceWalk object.
+             * @throw None
+             */
+            SequenceWalk(const ShardedMyContainer *container, bool towards_first, const std::vector<size_t> &split)
+                : owner(container), backward(towards_first), cursor(split)
+            {
+                for (size_t s = 0; s < cursor.size(); ++s)
+                {
+                    if (hasNext(s))
+                    {
+                        heap.push_back(s);
+                    }
+                }
+                std::make_heap(heap.begin(), heap.end(), [this](size_t a, size_t b)
+                               { return later(a, b); });
+            }
+
+            const T &current() const
+            {
+                size_t s = heap.front();
+                return owner->shards[s].getElements()[nextIndex(s)];
+            }
+
+            void advance()
+            {
+                if (heap.empty())
+                {
+                    return; // Already past the end
+                }
+                auto order = [this](size_t a, size_t b)
+                { return later(a, b); };
+                std::pop_heap(heap.begin(), heap.end(), order);
+                size_t s = heap.back();
+                heap.pop_back();
+                cursor[s] = backward ? cursor[s] - 1 : cursor[s] + 1;
+                if (hasNext(s))
+                {
+                    heap.push_back(s);
+                    std::push_heap(heap.begin(), heap.end(), order);
+                }
+            }
+        };
+
+    public:
+        /**
+         * @brief SequenceOrder Iterator Class
+         * Traverses the elements in insertion order, reverse insertion order or middle-out order without
+         * materializing them: one or two SequenceWalk merges over the shards yield the next element.
+         * Middle-out starts with a walk forward from the middle element and alternates it with a walk backward
+         * from it, the same positions as MyContainer::MiddleOutOrder.
+         *
+         * @note Copying the iterator costs O(k); it reads the shards in place (see ShardedMyContainer).
+         */
+        class SequenceOrder
+        {
+        private:
+            const ShardedMyContainer *owner;
+            OrderKind kind;
+            SequenceWalk primary;   // Yields position 0 and every position the secondary walk does not
+            SequenceWalk secondary; // Middle-out only: the left side of the middle
+            size_t interleaved;     // Odd positions up to 2 * interleaved come from the secondary walk
+            size_t total;
+            size_t current_index;
+
+            bool onSecondary() const { return current_index % 2 == 1 && current_index <= 2 * interleaved; }
+
+        public:
+            /**
+             * @brief Constructor for the SequenceOrder iterator.
+             * @param container The container to traverse.
+             * @param order OrderKind::Order, OrderKind::ReverseOrder or OrderKind::MiddleOutOrder.
+             * @returns SequenceOrder object.
+             * @throw std::invalid_argument if order is not based on insertion order.
+             */
+            SequenceOrder(const ShardedMyContainer *container, OrderKind order)
+                : owner(container), kind(order), interleaved(0), total(container->size()), current_index(0)
+            {
+                switch (order)
+                {
+                case OrderKind::Order:
+                    primary = SequenceWalk(container, false, container->splitAt(0));
+                    return;
+                case OrderKind::ReverseOrder:
+                    primary = SequenceWalk(container, true, container->splitAt(total));
+                    return;
+                case OrderKind::MiddleOutOrder:
+                {
+                    interleaved = total == 0 ? 0 : (total - 1) / 2;
+                    std::vector<size_t> middle = container->splitAt(interleaved);
+                    primary = SequenceWalk(container, false, middle);
+                    secondary = SequenceWalk(container, true, middle);
+                    return;
+                }
+                default:
+                    throw std::invalid_argument("Not an insertion-based order");
+                }
+            }
+
+            /**
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The size of the container when the iterator was created.
+             * @throw None
+             */
+            size_t size() const { return total; }
+
+            /**
+             * @brief Pre-increment operator for the SequenceOrder iterator, O(log k).
+             * @param None
+             * @returns Reference to the current SequenceOrder object after incrementing.
+             * @throw None
+             */
+            SequenceOrder &operator++()
+            {
+                if (current_index < total)
+                {
+                    (onSecondary() ? secondary : primary).advance();
+                }
+                ++current_index;
+                return *this;
+            }
+
+            /**
+             * @brief Post-increment operator for the SequenceOrder iterator.
+             * @param None
+             * @returns A copy of the SequenceOrder object before incrementing.
+             * @throw None
+             */
+            SequenceOrder operator++(int)
+            {
+                SequenceOrder temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            /**
+             * @brief Dereference operator for the SequenceOrder iterator.
+             * @param None
+             * @returns A constant reference to the current element.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &operator*() const
+            {
+                detail::checkIteratorIndex(current_index, total);
+                return (onSecondary() ? secondary : primary).current();
+            }
+
+            bool operator==(const SequenceOrder &other) const { return current_index == other.current_index; }
+
+            bool operator!=(const SequenceOrder &other) const { return !(*this == other); }
+
+            /**
+             * @brief Begin method for the SequenceOrder iterator.
+             * @param None
+             * @returns A new SequenceOrder iterator starting from the first element.
+             * @throw None
+             */
+            SequenceOrder begin() const { return SequenceOrder(owner, kind); }
+
+            /**
+             * @brief End method for the SequenceOrder iterator.
+             * @param None
+             * @returns A new SequenceOrder iterator pointing to one past the last element.
+             * @throw None
+             */
+            SequenceOrder end() const
+            {
+                SequenceOrder iter = *this;
+                iter.current_index = total;
+                return iter;
+            }
+        };
+
+        /**
+         * @brief SideCrossOrder Iterator Class
+         * Alternates between an ascending and a descending merge of the shards' sort caches, the same
+         * positions as MyContainer::SideCrossOrder.
+         *
+         * @note Like MergedOrder it works on a snapshot of the sort caches.
+         */
+        class SideCrossOrder
+        {
+        private:
+            MergedOrder<T, std::less<T>> ascending;     // Yields the even positions
+            MergedOrder<T, std::greater<T>> descending; // Yields the odd positions
+            size_t current_index;
+
+        public:
+            /**
+             * @brief Constructor for the SideCrossOrder iterator.
+             * @param containers The shards to merge.
+             * @returns SideCrossOrder object.
+             * @throw None
+             */
+            explicit SideCrossOrder(const std::vector<const MyContainer<T> *> &containers)
+                : ascending(containers, false), descending(containers, true), current_index(0) {}
+
+            size_t size() const { return ascending.size(); }
+
+            SideCrossOrder &operator++()
+            {
+                if (current_index < size())
+                {
+                    if (current_index % 2 == 0)
+                    {
+                        ++ascending;
+                    }
+                    else
+                    {
+                        ++descending;
+                    }
+                }
+                ++current_index;
+                return *this;
+            }
+
+            SideCrossOrder operator++(int)
+            {
+                SideCrossOrder temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            /**
+             * @brief Dereference operator for the SideCrossOrder iterator.
+             * @param None
+             * @returns A constant reference to the current element.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &operator*() const
+            {
+                detail::checkIteratorIndex(current_index, size());
+                return current_index % 2 == 0 ? *ascending : *descending;
+            }
+
+            bool operator==(const SideCrossOrder &other) const { return current_index == other.current_index; }
+
+            bool operator!=(const SideCrossOrder &other) const { return !(*this == other); }
+
+            SideCrossOrder begin() const
+            {
+                SideCrossOrder iter = *this;
+                iter.ascending = ascending.begin();
+                iter.descending = descending.begin();
+                iter.current_index = 0;
+                return iter;
+            }
+
+            SideCrossOrder end() const
+            {
+                SideCrossOrder iter = *this;
+                iter.current_index = size();
+                return iter;
+            }
+        };
+
+        /**
+         * @brief Returns the elements in global insertion order.
+         * Collects getOrder(), for callers that want a vector.
+         * @param None
+         * @returns The elements in the order they were added.
+         * @throw None
+         */
+        std::vector<T> insertionOrder() const
+        {
+            std::vector<T> ordered;
+            ordered.reserve(size());
+            SequenceOrder order = getOrder();
+            for (SequenceOrder it = order.begin(); it != order.end(); ++it)
+            {
+                ordered.push_back(*it);
+            }
+            return ordered;
+        }
+
+        /**
+         * @brief Returns every shard as a merge source.
+         * @param None
+         * @returns Pointers to the shards.
+         * @throw None
+         */
+        std::vector<const MyContainer<T> *> shardPointers() const
+        {
+            std::vector<const MyContainer<T> *> pointers;
+            for (size_t s = 0; s < shards.size(); ++s)
+            {
+                pointers.push_back(&shards[s]);
+            }
+            return pointers;
+        }
+
+        // Factory methods to create iterators, merged from the shards' sort caches:
+        MergedOrder<T, std::less<T>> getAscendingOrder() const
+        {
+            prepareSorted();
+            return mergeAscending(shardPointers());
+        }
+
+        MergedOrder<T, std::greater<T>> getDescendingOrder() const
+        {
+            prepareSorted();
+            return mergeDescending(shardPointers());
+        }
+
+        SideCrossOrder getSideCrossOrder() const
+        {
+            prepareSorted();
+            return SideCrossOrder(shardPointers());
+        }
+
+        // Factory methods to create iterators, merged from the shards on their sequence numbers:
+        SequenceOrder getOrder() const { return SequenceOrder(this, OrderKind::Order); }
+
+        SequenceOrder getReverseOrder() const { return SequenceOrder(this, OrderKind::ReverseOrder); }
+
+        SequenceOrder getMiddleOutOrder() const { return SequenceOrder(this, OrderKind::MiddleOutOrder); }
+    };
+}
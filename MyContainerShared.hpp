@@ -0,0 +1,322 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <algorithm>   // for std::upper_bound, std::lower_bound, std::remove
+#include <atomic>      // for std::atomic, std::atomic_thread_fence
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint32_t, uint64_t
+#include <cstring>     // for std::memmove
+#include <new>         // for placement new
+#include <stdexcept>   // for std::runtime_error, std::invalid_argument, std::length_error
+#include <string>      // for std::string
+#include <thread>      // for std::this_thread::yield
+#include <type_traits> // for std::is_trivially_copyable
+#include <fcntl.h>     // for O_* flags
+#include <sys/mman.h>  // for ::shm_open, ::mmap
+#include <sys/stat.h>  // for ::fstat
+#include <unistd.h>    // for ::ftruncate, ::close
+#include "MyContainerView.hpp"
+
+namespace my_cont_ns
+{
+    /**
+     * @brief Container whose elements and ascending sort cache live in a POSIX shared-memory segment, so that
+     * several local processes traverse one copy instead of keeping their own.
+     * The process that creates the segment is the writer; other processes open it by name as readers and get
+     * all six orders through view(), straight from the segment. Consistency is kept with a process-shared
+     * seqlock: the writer makes the sequence odd while it changes the segment, and read() retries a reader's
+     * traversal until it ran entirely between two writes.
+     *
+     * @note The capacity is fixed when the segment is created. add() and remove() keep the sorted copy up to
+     * date, which costs O(n) per call; the container is meant for read-mostly reference data.
+     * Requires a trivially copyable T.
+     */
+    template <typename T = int>
+    class SharedMyContainer
+    {
+    private:
+        static_assert(std::is_trivially_copyable<T>::value, "SharedMyContainer stores raw elements and requires a trivially copyable type");
+        static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The seqlock needs lock-free 64-bit atomics to be shared between processes");
+
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t element_size;
+            uint64_t capacity;
+            std::atomic<uint64_t> sequence; // Odd while the writer changes the segment
+            std::atomic<uint64_t> count;
+            unsigned char padding[32];      // Keeps the elements 64-byte aligned
+        };
+
+        static const uint32_t MAGIC = 0x4853594d; // "MYSH"
+
+        std::string segment_name;
+        Header *header;
+        T *elements; // Insertion order, capacity slots
+        T *sorted;   // Ascending order of the same elements, capacity slots
+        size_t mapped_bytes;
+        bool owner; // Created the segment: may write, and unlinks it on destruction
+
+        SharedMyContainer(const SharedMyContainer &);
+        SharedMyContainer &operator=(const SharedMyContainer &);
+
+        static size_t bytesFor(size_t capacity) { return sizeof(Header) + 2 * capacity * sizeof(T); }
+
+        /**
+         * @brief Maps the segment and sets the element pointers.
+         * @param fd The segment.
+         * @param bytes Size of the segment.
+         * @param writable true to map it for writing.
+         * @returns void
+         * @throw std::runtime_error if the segment cannot be mapped.
+         */
+        void map(int fd, size_t bytes, bool writable)
+        {
+            void *mapping = ::mmap(NULL, bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd); // The mapping keeps the segment reachable
+            if (mapping == MAP_FAILED)
+            {
+                throw std::runtime_error("Cannot map shared memory segment: " + segment_name);
+            }
+            mapped_bytes = bytes;
+            header = static_cast<Header *>(mapping);
+            elements = reinterpret_cast<T *>(header + 1);
+        }
+
+        /**
+         * @brief Throws unless this process created the segment.
+         * @param None
+         * @returns void
+         * @throw std::runtime_error if the container was opened as a reader.
+         */
+        void requireWriter() const
+        {
+            if (!owner)
+            {
+                throw std::runtime_error("Shared container is opened read-only: " + segment_name);
+            }
+        }
+
+        // == Seqlock write section (writer only, one writer per segment) ==
+
+        void beginWrite()
+        {
+            header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        void endWrite()
+        {
+            header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+    public:
+        /**
+         * @brief Creates (or replaces) a shared segment and opens it as the writer.
+         * @param name Segment name, of the form "/name".
+         * @param capacity Maximum number of elements.
+         * @returns SharedMyContainer object, empty.
+         * @throw std::runtime_error if the segment cannot be created or mapped.
+         */
+        SharedMyContainer(const std::string &name, size_t capacity)
+            : segment_name(name), header(NULL), elements(NULL), sorted(NULL), mapped_bytes(0), owner(true)
+        {
+            int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Cannot create shared memory segment: " + name);
+            }
+            const size_t bytes = bytesFor(capacity);
+            if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+            {
+                ::close(fd);
+                ::shm_unlink(name.c_str());
+                throw std::runtime_error("Cannot size shared memory segment: " + name);
+            }
+            try
+            {
+                map(fd, bytes, true);
+            }
+            catch (...)
+            {
+                ::shm_unlink(name.c_str());
+                throw;
+            }
+            header->magic = MAGIC;
+            header->element_size = sizeof(T);
+            header->capacity = capacity;
+            new (&header->sequence) std::atomic<uint64_t>(0);
+            new (&header->count) std::atomic<uint64_t>(0);
+            sorted = elements + capacity;
+        }
+
+        /**
+         * @brief Opens an existing shared segment as a reader.
+         * @param name Segment name, as passed to the creating constructor.
+         * @returns SharedMyContainer object over the writer's elements.
+         * @throw std::runtime_error if the segment does not exist or holds another element type.
+         */
+        explicit SharedMyContainer(const std::string &name)
+            : segment_name(name), header(NULL), elements(NULL), sorted(NULL), mapped_bytes(0), owner(false)
+        {
+            int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Cannot open shared memory segment: " + name);
+            }
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+            {
+                ::close(fd);
+                throw std::runtime_error("Not a shared container segment: " + name);
+            }
+            map(fd, static_cast<size_t>(info.st_size), false);
+            if (header->magic != MAGIC || header->element_size != sizeof(T) || bytesFor(header->capacity) > mapped_bytes)
+            {
+                ::munmap(header, mapped_bytes);
+                throw std::runtime_error("Shared segment holds another element type or is corrupted: " + name);
+            }
+            sorted = elements + header->capacity;
+        }
+
+        /**
+         * @brief Destructor, unmaps the segment; the writer also removes its name.
+         * Processes that still have the segment mapped keep reading it.
+         * @param None
+         * @returns None
+         * @throw None
+         */
+        ~SharedMyContainer()
+        {
+            ::munmap(header, mapped_bytes);
+            if (owner)
+            {
+                ::shm_unlink(segment_name.c_str());
+            }
+        }
+
+        /**
+         * @brief Returns the number of elements in the container.
+         * @param None
+         * @returns The size of the container at the time of the call.
+         * @throw None
+         */
+        size_t size() const { return static_cast<size_t>(header->count.load(std::memory_order_acquire)); }
+
+        /**
+         * @brief Checks if the container is empty.
+         * @param None
+         * @returns true if the container has no elements, false otherwise.
+         * @throw None
+         */
+        bool isEmpty() const { return size() == 0; }
+
+        /**
+         * @brief Returns the maximum number of elements.
+         * @param None
+         * @returns The capacity the segment was created with.
+         * @throw None
+         */
+        size_t capacity() const { return static_cast<size_t>(header->capacity); }
+
+        /**
+         * @brief Returns the seqlock sequence, which changes on every add() and remove().
+         * @param None
+         * @returns An even value when no write is in progress.
+         * @throw None
+         */
+        uint64_t version() const { return header->sequence.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Adds an element to the container and inserts it into the shared sorted copy.
+         * @param element The element to add to the container.
+         * @returns void
+         * @throw std::runtime_error if the container was opened as a reader.
+         * @throw std::length_error if the container is full.
+         */
+        void add(const T &element)
+        {
+            requireWriter();
+            const size_t count = size();
+            if (count == capacity())
+            {
+                throw std::length_error("Shared container is full: " + segment_name);
+            }
+            T *slot = std::upper_bound(sorted, sorted + count, element);
+            beginWrite();
+            elements[count] = element;
+            std::memmove(slot + 1, slot, static_cast<size_t>(sorted + count - slot) * sizeof(T));
+            *slot = element;
+            header->count.store(count + 1, std::memory_order_relaxed);
+            endWrite();
+        }
+
+        /**
+         * @brief Removes all occurrences of the specified element from the container.
+         * @param element The element to remove from the container.
+         * @returns void
+         * @throw std::runtime_error if the container was opened as a reader.
+         * @throw std::invalid_argument if the element is not found.
+         */
+        void remove(const T &element)
+        {
+            requireWriter();
+            const size_t count = size();
+            T *first = std::lower_bound(sorted, sorted + count, element);
+            T *last = std::upper_bound(first, sorted + count, element);
+            if (first == last)
+            {
+                throw std::invalid_argument("Element not found in container");
+            }
+            beginWrite();
+            std::memmove(first, last, static_cast<size_t>(sorted + count - last) * sizeof(T));
+            T *new_end = std::remove(elements, elements + count, element);
+            header->count.store(static_cast<size_t>(new_end - elements), std::memory_order_relaxed);
+            endWrite();
+        }
+
+        /**
+         * @brief Returns a view with all six orders over the shared segment, without copying it.
+         *
+         * @note The view is not synchronized: a reader must traverse it inside read() (or know the writer is idle),
+         * otherwise a concurrent add() or remove() may be observed half-done.
+         *
+         * @param None
+         * @returns View over the elements, with the shared sorted copy serving the sorted orders.
+         * @throw None
+         */
+        MyContainerView<T> view() const { return MyContainerView<T>(elements, sorted, size()); }
+
+        /**
+         * @brief Runs a traversal against a consistent state of the segment.
+         * fn is called with a view of the elements; if the writer changed the segment during the call, fn is
+         * called again on a fresh view until one call ran entirely between two writes.
+         *
+         * @note fn may be called several times and may observe a torn state in the calls that are retried,
+         * so it should only compute a result (e.g. into a local it resets on entry).
+         *
+         * @param fn Callable invoked as fn(MyContainerView<T>).
+         * @returns void
+         * @throw Whatever fn throws.
+         */
+        template <typename Function>
+        void read(Function fn) const
+        {
+            while (true)
+            {
+                uint64_t before = header->sequence.load(std::memory_order_acquire);
+                if (before & 1)
+                {
+                    std::this_thread::yield(); // A write is in progress
+                    continue;
+                }
+                fn(view());
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (header->sequence.load(std::memory_order_relaxed) == before)
+                {
+                    return;
+                }
+            }
+        }
+    };
+}
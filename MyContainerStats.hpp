@@ -0,0 +1,240 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <atomic>    // for std::atomic
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstddef>   // for size_t
+#include <sstream>   // for std::ostringstream
+#include <string>    // for std::string
+
+/**
+ * @brief Opt-in instrumentation counters.
+ * Compile with -DMYCONTAINER_STATS to give every MyContainer a stats() API.
+ * Without the flag the counters and all the code that updates them are compiled out.
+ */
+#ifdef MYCONTAINER_STATS
+#define MYCONTAINER_STAT(statement) statement
+#else
+#define MYCONTAINER_STAT(statement)
+#endif
+
+namespace my_cont_ns
+{
+    /**
+     * @brief Per-container instrumentation counters (see MYCONTAINER_STATS).
+     * Counters are relaxed atomics, so iterators may be built concurrently from one const container.
+     */
+    class ContainerStats
+    {
+    public:
+        // Iterator types counted by iterator_constructions (the six orders first, in OrderKind order)
+        static const size_t ITERATOR_KINDS = 8;
+        static const size_t DISTINCT_ASCENDING = 6;
+        static const size_t GROUPED_ASCENDING = 7;
+
+        std::atomic<unsigned long long> adds;            // add() calls
+        std::atomic<unsigned long long> removes;         // remove() calls that found the element
+        std::atomic<unsigned long long> remove_misses;   // remove() calls that threw (element not found)
+        std::atomic<unsigned long long> iterator_constructions[ITERATOR_KINDS]; // Iterators built, per type
+        std::atomic<unsigned long long> sorts;           // Full sorts performed
+        std::atomic<unsigned long long> sort_cache_hits; // Sorted reads served by the sort cache without sorting
+        std::atomic<unsigned long long> background_sorts; // Sort caches published by the background sort worker
+        std::atomic<unsigned long long> elements_copied; // Elements copied into iterator snapshots and the sort cache
+        std::atomic<unsigned long long> bytes_copied;    // sizeof(T) * elements_copied (heap memory owned by T not included)
+        std::atomic<unsigned long long> snapshot_nanos;  // Total time spent building iterator snapshots
+
+        /**
+         * @brief Default constructor, all counters start at zero.
+         * @param None
+         * @returns ContainerStats object.
+         * @throw None
+         */
+        ContainerStats()
+        {
+            reset();
+        }
+
+        /**
+         * @brief Copy constructor, takes a relaxed snapshot of every counter.
+         * @param other The counters to copy.
+         * @returns ContainerStats object.
+         * @throw None
+         */
+        ContainerStats(const ContainerStats &other)
+        {
+            *this = other;
+        }
+
+        /**
+         * @brief Copy assignment, takes a relaxed snapshot of every counter.
+         * @param other The counters to copy.
+         * @returns Reference to this object.
+         * @throw None
+         */
+        ContainerStats &operator=(const ContainerStats &other)
+        {
+            adds.store(other.adds.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            removes.store(other.removes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            remove_misses.store(other.remove_misses.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            for (size_t i = 0; i < ITERATOR_KINDS; ++i)
+            {
+                iterator_constructions[i].store(other.iterator_constructions[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            sorts.store(other.sorts.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            sort_cache_hits.store(other.sort_cache_hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            background_sorts.store(other.background_sorts.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            elements_copied.store(other.elements_copied.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            bytes_copied.store(other.bytes_copied.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            snapshot_nanos.store(other.snapshot_nanos.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        /**
+         * @brief Sets every counter back to zero.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void reset()
+        {
+            adds.store(0, std::memory_order_relaxed);
+            removes.store(0, std::memory_order_relaxed);
+            remove_misses.store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < ITERATOR_KINDS; ++i)
+            {
+                iterator_constructions[i].store(0, std::memory_order_relaxed);
+            }
+            sorts.store(0, std::memory_order_relaxed);
+            sort_cache_hits.store(0, std::memory_order_relaxed);
+            background_sorts.store(0, std::memory_order_relaxed);
+            elements_copied.store(0, std::memory_order_relaxed);
+            bytes_copied.store(0, std::memory_order_relaxed);
+            snapshot_nanos.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Counts elements copied into an iterator snapshot or the sort cache.
+         * @param elements Number of elements copied.
+         * @param element_size sizeof(T).
+         * @returns void
+         * @throw None
+         */
+        void recordCopy(size_t elements, size_t element_size)
+        {
+            elements_copied.fetch_add(elements, std::memory_order_relaxed);
+            bytes_copied.fetch_add(elements * element_size, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Returns the name of an iterator type counted by iterator_constructions.
+         * @param kind Index into iterator_constructions.
+         * @returns The iterator class name.
+         * @throw None
+         */
+        static const char *iteratorName(size_t kind)
+        {
+            static const char *const names[ITERATOR_KINDS] = {
+                "AscendingOrder", "DescendingOrder", "SideCrossOrder", "ReverseOrder",
+                "Order", "MiddleOutOrder", "DistinctAscendingOrder", "GroupedAscendingOrder"};
+            return kind < ITERATOR_KINDS ? names[kind] : "Unknown";
+        }
+
+        /**
+         * @brief Formats the counters as human readable text, one counter per line.
+         * @param None
+         * @returns The formatted counters.
+         * @throw None
+         */
+        std::string toText() const
+        {
+            std::ostringstream out;
+            out << "adds:            " << adds.load(std::memory_order_relaxed) << "\n";
+            out << "removes:         " << removes.load(std::memory_order_relaxed) << "\n";
+            out << "remove misses:   " << remove_misses.load(std::memory_order_relaxed) << "\n";
+            for (size_t i = 0; i < ITERATOR_KINDS; ++i)
+            {
+                out << "iterators built: " << iteratorName(i) << " = " << iterator_constructions[i].load(std::memory_order_relaxed) << "\n";
+            }
+            out << "sorts:           " << sorts.load(std::memory_order_relaxed) << "\n";
+            out << "sort cache hits: " << sort_cache_hits.load(std::memory_order_relaxed) << "\n";
+            out << "background sorts: " << background_sorts.load(std::memory_order_relaxed) << "\n";
+            out << "elements copied: " << elements_copied.load(std::memory_order_relaxed) << "\n";
+            out << "bytes copied:    " << bytes_copied.load(std::memory_order_relaxed) << "\n";
+            out << "snapshot time:   " << snapshot_nanos.load(std::memory_order_relaxed) / 1000 << " us\n";
+            return out.str();
+        }
+
+        /**
+         * @brief Formats the counters as a single JSON object.
+         * @param None
+         * @returns The JSON text.
+         * @throw None
+         */
+        std::string toJson() const
+        {
+            std::ostringstream out;
+            out << "{\"adds\": " << adds.load(std::memory_order_relaxed)
+                << ", \"removes\": " << removes.load(std::memory_order_relaxed)
+                << ", \"remove_misses\": " << remove_misses.load(std::memory_order_relaxed)
+                << ", \"iterator_constructions\": {";
+            for (size_t i = 0; i < ITERATOR_KINDS; ++i)
+            {
+                out << (i == 0 ? "" : ", ") << "\"" << iteratorName(i) << "\": " << iterator_constructions[i].load(std::memory_order_relaxed);
+            }
+            out << "}, \"sorts\": " << sorts.load(std::memory_order_relaxed)
+                << ", \"sort_cache_hits\": " << sort_cache_hits.load(std::memory_order_relaxed)
+                << ", \"background_sorts\": " << background_sorts.load(std::memory_order_relaxed)
+                << ", \"elements_copied\": " << elements_copied.load(std::memory_order_relaxed)
+                << ", \"bytes_copied\": " << bytes_copied.load(std::memory_order_relaxed)
+                << ", \"snapshot_nanos\": " << snapshot_nanos.load(std::memory_order_relaxed) << "}";
+            return out.str();
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Records one iterator snapshot build: its type and duration.
+         * Created at the start of an iterator constructor, the duration is taken when it goes out of scope.
+         * Copies are counted where they happen (see ContainerStats::recordCopy()), since cached orders copy nothing.
+         */
+        class SnapshotScope
+        {
+        private:
+            ContainerStats &stats;
+            std::chrono::steady_clock::time_point start;
+
+        public:
+            /**
+             * @brief Constructor for SnapshotScope.
+             * @param stats The counters of the container being iterated.
+             * @param kind Index of the iterator type (see ContainerStats::iteratorName()).
+             * @returns SnapshotScope object.
+             * @throw None
+             */
+            SnapshotScope(ContainerStats &stats, size_t kind)
+                : stats(stats), start(std::chrono::steady_clock::now())
+            {
+                stats.iterator_constructions[kind].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Destructor, adds the elapsed time to the snapshot time counter.
+             * @param None
+             * @returns None
+             * @throw None
+             */
+            ~SnapshotScope()
+            {
+                std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+                stats.snapshot_nanos.fetch_add(static_cast<unsigned long long>(
+                                                   std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                                               std::memory_order_relaxed);
+            }
+
+        private:
+            SnapshotScope(const SnapshotScope &);
+            SnapshotScope &operator=(const SnapshotScope &);
+        };
+    }
+}
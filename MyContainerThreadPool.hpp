@@ -0,0 +1,463 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <algorithm>          // for std::sort, std::inplace_merge
+#include <atomic>             // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstddef>            // for size_t
+#include <cstdlib>            // for std::getenv, std::strtoul
+#include <deque>              // for std::deque
+#include <exception>          // for std::exception_ptr
+#include <functional>         // for std::function
+#include <memory>             // for std::unique_ptr
+#include <mutex>              // for std::mutex
+#include <thread>             // for std::thread
+#include <utility>            // for std::pair
+#include <vector>             // for std::vector
+
+namespace my_cont_ns
+{
+    /**
+     * @brief Work-stealing task scheduler behind the library's parallel operations.
+     * Every worker owns a deque: it pushes and pops its own tasks at the back, and idle workers steal from the
+     * front of the others' deques. Tasks submitted from outside the pool go to a separate injection deque.
+     * The fork-join calls (parallelFor(), parallelInvoke()) run one share of the work on the calling thread
+     * and keep running pool tasks while they wait, so they may nest without deadlocking.
+     *
+     * @note A pool with 0 workers runs everything on the calling thread.
+     */
+    class ThreadPool
+    {
+    private:
+        typedef std::function<void()> Task;
+
+        struct TaskQueue
+        {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<TaskQueue>> queues; // One per worker, then the injection queue
+        std::vector<std::thread> threads;
+        std::atomic<size_t> queued; // Tasks in all queues
+        std::mutex sleep_lock;
+        std::condition_variable wake;
+        bool stopping;
+
+        ThreadPool(const ThreadPool &);
+        ThreadPool &operator=(const ThreadPool &);
+
+        /**
+         * @brief Returns the pool and worker index of the calling thread.
+         * @param None
+         * @returns Reference to the thread's (pool, index) pair; pool is null outside every pool.
+         * @throw None
+         */
+        static std::pair<const ThreadPool *, size_t> &currentWorker()
+        {
+            static thread_local std::pair<const ThreadPool *, size_t> current(NULL, 0);
+            return current;
+        }
+
+        /**
+         * @brief Returns the queue the calling thread pushes to and pops from first.
+         * @param None
+         * @returns The worker's own queue, or the injection queue for threads outside this pool.
+         * @throw None
+         */
+        size_t homeQueue() const
+        {
+            const std::pair<const ThreadPool *, size_t> &current = currentWorker();
+            return current.first == this ? current.second : queues.size() - 1;
+        }
+
+        /**
+         * @brief Takes one task: the newest of the home queue, otherwise the oldest of another queue.
+         * @param task Receives the task.
+         * @returns true if a task was taken.
+         * @throw None
+         */
+        bool take(Task &task)
+        {
+            const size_t home = homeQueue();
+            {
+                TaskQueue &own = *queues[home];
+                std::lock_guard<std::mutex> guard(own.lock);
+                if (!own.tasks.empty())
+                {
+                    task.swap(own.tasks.back());
+                    own.tasks.pop_back();
+                    queued.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            for (size_t offset = 1; offset < queues.size(); ++offset)
+            {
+                TaskQueue &victim = *queues[(home + offset) % queues.size()];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.tasks.empty())
+                {
+                    task.swap(victim.tasks.front()); // Steal the oldest, usually the largest piece of work
+                    victim.tasks.pop_front();
+                    queued.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Main loop of a worker thread.
+         * @param index Index of the worker's queue.
+         * @returns void
+         * @throw None
+         */
+        void workerLoop(size_t index)
+        {
+            currentWorker() = std::make_pair(this, index);
+            Task task;
+            while (true)
+            {
+                if (take(task))
+                {
+                    task();
+                    task = Task();
+                    continue;
+                }
+                std::unique_lock<std::mutex> guard(sleep_lock);
+                wake.wait(guard, [this]()
+                          { return stopping || queued.load(std::memory_order_relaxed) != 0; });
+                if (stopping && queued.load(std::memory_order_relaxed) == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief Completion tracking of one fork-join call.
+         * Collects the first exception of its tasks and lets the waiting thread help with pool work.
+         */
+        class TaskGroup
+        {
+        private:
+            ThreadPool &pool;
+            std::atomic<size_t> pending;
+            std::mutex error_lock;
+            std::exception_ptr error;
+
+        public:
+            explicit TaskGroup(ThreadPool &owner) : pool(owner), pending(0) {}
+
+            /**
+             * @brief Records the current exception if it is the group's first.
+             * @param None
+             * @returns void
+             * @throw None
+             */
+            void fail()
+            {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+
+            /**
+             * @brief Submits a task to the pool as part of the group.
+             * @param fn Callable invoked as fn().
+             * @returns void
+             * @throw std::bad_alloc if the task cannot be queued, or whatever copying fn throws; the task then
+             * does not count as pending.
+             */
+            template <typename Function>
+            void run(Function fn)
+            {
+                pending.fetch_add(1, std::memory_order_relaxed);
+                try
+                {
+                    pool.submit([this, fn]()
+                                {
+                                    try
+                                    {
+                                        fn();
+                                    }
+                                    catch (...)
+                                    {
+                                        fail();
+                                    }
+                                    pending.fetch_sub(1, std::memory_order_release); });
+                }
+                catch (...)
+                {
+                    pending.fetch_sub(1, std::memory_order_relaxed);
+                    throw;
+                }
+            }
+
+            /**
+             * @brief Runs pool tasks until every task of the group finished.
+             * @param None
+             * @returns void
+             * @throw The first exception thrown by a task of the group.
+             */
+            void wait()
+            {
+                Task task;
+                while (pending.load(std::memory_order_acquire) != 0)
+                {
+                    if (pool.take(task))
+                    {
+                        task();
+                        task = Task();
+                    }
+                    else
+                    {
+                        std::this_thread::yield(); // The remaining tasks run on other threads
+                    }
+                }
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+
+    public:
+        /**
+         * @brief Constructor for ThreadPool.
+         * @param workers Number of worker threads; the thread calling parallelFor()/parallelInvoke() works too,
+         *        so workers + 1 threads share the work.
+         * @returns ThreadPool object with its workers started.
+         * @throw std::system_error if a thread cannot be started.
+         */
+        explicit ThreadPool(size_t workers) : queued(0), stopping(false)
+        {
+            for (size_t i = 0; i <= workers; ++i)
+            {
+                queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+            }
+            for (size_t i = 0; i < workers; ++i)
+            {
+                threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+            }
+        }
+
+        /**
+         * @brief Destructor, runs the queued tasks and joins the workers.
+         * @param None
+         * @returns None
+         * @throw None
+         */
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> guard(sleep_lock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (size_t i = 0; i < threads.size(); ++i)
+            {
+                threads[i].join();
+            }
+        }
+
+        /**
+         * @brief Returns the process-wide pool used by the library's parallel operations.
+         * Its size is taken from the MYCONTAINER_THREADS environment variable (total threads, including the
+         * caller) when set, otherwise from the number of hardware threads.
+         * @param None
+         * @returns Reference to the pool, created on first use.
+         * @throw None
+         */
+        static ThreadPool &instance()
+        {
+            static ThreadPool pool(defaultWorkerCount());
+            return pool;
+        }
+
+        /**
+         * @brief Returns the worker count of instance().
+         * @param None
+         * @returns One less than MYCONTAINER_THREADS or the number of hardware threads.
+         * @throw None
+         */
+        static size_t defaultWorkerCount()
+        {
+            const char *configured = std::getenv("MYCONTAINER_THREADS");
+            size_t threads = configured != NULL ? static_cast<size_t>(std::strtoul(configured, NULL, 10))
+                                                : static_cast<size_t>(std::thread::hardware_concurrency());
+            return threads > 1 ? threads - 1 : 0;
+        }
+
+        /**
+         * @brief Returns the number of worker threads.
+         * @param None
+         * @returns The worker count given at construction.
+         * @throw None
+         */
+        size_t workerCount() const { return threads.size(); }
+
+        /**
+         * @brief Queues a task (on the calling worker's own deque when called from inside the pool).
+         * @param task The task; exceptions must not escape it.
+         * @returns void
+         * @throw std::bad_alloc if the task cannot be queued.
+         */
+        void submit(Task task)
+        {
+            if (threads.empty())
+            {
+                task(); // Nobody else would ever run it
+                return;
+            }
+            {
+                // Counted before it is visible, so that take() never decrements below zero
+                std::lock_guard<std::mutex> guard(sleep_lock); // Orders the count with a worker's sleep check
+                queued.fetch_add(1, std::memory_order_relaxed);
+            }
+            try
+            {
+                TaskQueue &home = *queues[homeQueue()];
+                std::lock_guard<std::mutex> guard(home.lock);
+                home.tasks.push_back(std::move(task));
+            }
+            catch (...)
+            {
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+            wake.notify_one();
+        }
+
+        /**
+         * @brief Runs fn over [begin, end) split into chunks of at least grain indices, in parallel.
+         * The calling thread runs the first chunk; the others are queued for the workers.
+         * @param begin First index.
+         * @param end One past the last index.
+         * @param grain Minimum number of indices per chunk (0 is treated as 1).
+         * @param fn Callable invoked as fn(size_t chunk_begin, size_t chunk_end), once per chunk.
+         * @returns void
+         * @throw The first exception thrown by fn, after every chunk finished; if a chunk cannot be queued, the
+         * first error after the chunks already queued finished.
+         */
+        template <typename Function>
+        void parallelFor(size_t begin, size_t end, size_t grain, Function fn)
+        {
+            if (end <= begin)
+            {
+                return;
+            }
+            const size_t count = end - begin;
+            grain = std::max<size_t>(grain, 1);
+            // A few chunks per thread, so that stealing can even out uneven chunks
+            size_t chunks = std::min((count + grain - 1) / grain, 4 * (threads.size() + 1));
+            if (threads.empty() || chunks <= 1)
+            {
+                fn(begin, end);
+                return;
+            }
+            TaskGroup group(*this);
+            const size_t step = count / chunks;
+            const size_t extra = count % chunks; // The first extra chunks take one more index
+            size_t first_end = begin + step + (extra != 0);
+            size_t chunk_begin = first_end;
+            try
+            {
+                for (size_t chunk = 1; chunk < chunks; ++chunk)
+                {
+                    size_t chunk_end = chunk_begin + step + (chunk < extra);
+                    group.run([fn, chunk_begin, chunk_end]()
+                              { fn(chunk_begin, chunk_end); });
+                    chunk_begin = chunk_end;
+                }
+            }
+            catch (...)
+            {
+                // The queued chunks point to group, so they must finish first; wait() then rethrows
+                group.fail();
+                group.wait();
+            }
+            try
+            {
+                fn(begin, first_end);
+            }
+            catch (...)
+            {
+                group.fail();
+            }
+            group.wait();
+        }
+
+        /**
+         * @brief Runs two callables in parallel and returns when both finished.
+         * @param first Callable invoked as first() on the calling thread.
+         * @param second Callable invoked as second() on a worker (or the calling thread if none is free).
+         * @returns void
+         * @throw The first exception thrown by either callable, after both finished, or std::bad_alloc if
+         * second cannot be queued.
+         */
+        template <typename First, typename Second>
+        void parallelInvoke(First first, Second second)
+        {
+            if (threads.empty())
+            {
+                first();
+                second();
+                return;
+            }
+            TaskGroup group(*this);
+            try
+            {
+                group.run(second);
+            }
+            catch (...)
+            {
+                group.fail();
+                group.wait();
+            }
+            try
+            {
+                first();
+            }
+            catch (...)
+            {
+                group.fail();
+            }
+            group.wait();
+        }
+    };
+
+    namespace detail
+    {
+        // Below this many elements parallelSort() sorts on one thread
+        static const size_t PARALLEL_SORT_GRAIN = 1 << 15;
+
+        /**
+         * @brief Fork-join merge sort: both halves are sorted in parallel, then merged in place.
+         * @param pool The pool that runs the halves.
+         * @param first First element.
+         * @param last One past the last element.
+         * @param compare Strict weak ordering.
+         * @returns void
+         * @throw Whatever the element comparisons or moves throw.
+         */
+        template <typename Iterator, typename Compare>
+        void parallelSort(ThreadPool &pool, Iterator first, Iterator last, Compare compare)
+        {
+            const size_t count = static_cast<size_t>(last - first);
+            if (pool.workerCount() == 0 || count <= PARALLEL_SORT_GRAIN)
+            {
+                std::sort(first, last, compare);
+                return;
+            }
+            Iterator middle = first + count / 2;
+            pool.parallelInvoke([&]()
+                                { parallelSort(pool, first, middle, compare); },
+                                [&]()
+                                { parallelSort(pool, middle, last, compare); });
+            std::inplace_merge(first, middle, last, compare);
+        }
+    }
+}
@@ -0,0 +1,265 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <atomic>    // for std::atomic
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstddef>   // for size_t
+#include <fstream>   // for std::ofstream
+#include <iomanip>   // for std::setprecision
+#include <memory>    // for std::shared_ptr
+#include <mutex>     // for std::mutex
+#include <stdexcept> // for std::runtime_error
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+/**
+ * @brief Opt-in timeline tracing.
+ * Compile with -DMYCONTAINER_TRACE to record begin/end events of snapshot builds, sorts and bulk mutations,
+ * and export them with Tracer::instance().writeChromeTrace(path) (load the file in chrome://tracing or Perfetto).
+ * Without the flag the scopes are compiled out.
+ */
+#ifdef MYCONTAINER_TRACE
+#define MYCONTAINER_TRACE_SCOPE(name, count) my_cont_ns::detail::TraceScope trace_scope((name), (count))
+#else
+#define MYCONTAINER_TRACE_SCOPE(name, count)
+#endif
+
+namespace my_cont_ns
+{
+    /**
+     * @brief One recorded trace event.
+     */
+    struct TraceEvent
+    {
+        const char *name;        // Event name (string literal or static string)
+        char phase;              // 'B' (begin) or 'E' (end), as in the Chrome trace format
+        unsigned long long nanos; // Time since the tracer started
+        unsigned thread_id;      // Small sequential id of the recording thread
+        size_t count;            // Number of elements involved
+    };
+
+    /**
+     * @brief Process-wide trace recorder with one ring buffer per thread.
+     * Each thread writes only to its own buffer, so recording never contends with other recording threads.
+     * When a ring is full the oldest events of that thread are overwritten.
+     */
+    class Tracer
+    {
+    private:
+        /**
+         * @brief Ring buffer of one thread.
+         * The mutex is only contended while the trace is being exported.
+         */
+        struct ThreadBuffer
+        {
+            std::mutex lock;
+            std::vector<TraceEvent> ring;
+            size_t next;   // Slot of the next event
+            bool wrapped;  // true once the oldest events started being overwritten
+            unsigned thread_id;
+        };
+
+        std::mutex registry_lock;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers; // Every buffer ever created (outlives its thread)
+        std::atomic<size_t> capacity;                       // Events per thread buffer
+        std::atomic<unsigned> next_thread_id;
+        std::chrono::steady_clock::time_point epoch;
+
+        Tracer() : capacity(1 << 16), next_thread_id(1), epoch(std::chrono::steady_clock::now()) {}
+        Tracer(const Tracer &);
+        Tracer &operator=(const Tracer &);
+
+        /**
+         * @brief Returns the calling thread's buffer, creating and registering it on first use.
+         * @param None
+         * @returns Reference to the buffer.
+         * @throw None
+         */
+        ThreadBuffer &localBuffer()
+        {
+            static thread_local std::shared_ptr<ThreadBuffer> local;
+            if (!local)
+            {
+                std::shared_ptr<ThreadBuffer> created = std::make_shared<ThreadBuffer>();
+                created->ring.resize(capacity.load(std::memory_order_relaxed));
+                created->next = 0;
+                created->wrapped = false;
+                created->thread_id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> guard(registry_lock);
+                buffers.push_back(created);
+                local = created;
+            }
+            return *local;
+        }
+
+    public:
+        /**
+         * @brief Returns the process-wide tracer.
+         * @param None
+         * @returns Reference to the tracer.
+         * @throw None
+         */
+        static Tracer &instance()
+        {
+            static Tracer tracer;
+            return tracer;
+        }
+
+        /**
+         * @brief Sets the number of events kept per thread.
+         *
+         * @note Applies to buffers of threads that record their first event afterwards.
+         *
+         * @param events Ring size in events (at least 1).
+         * @returns void
+         * @throw None
+         */
+        void setBufferCapacity(size_t events)
+        {
+            capacity.store(events == 0 ? 1 : events, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Records one event in the calling thread's ring buffer.
+         * @param name Event name, must stay valid until the trace is written.
+         * @param phase 'B' for begin, 'E' for end.
+         * @param count Number of elements involved.
+         * @returns void
+         * @throw None
+         */
+        void record(const char *name, char phase, size_t count)
+        {
+            ThreadBuffer &buffer = localBuffer();
+            TraceEvent event;
+            event.name = name;
+            event.phase = phase;
+            event.nanos = static_cast<unsigned long long>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+            event.thread_id = buffer.thread_id;
+            event.count = count;
+
+            std::lock_guard<std::mutex> guard(buffer.lock);
+            buffer.ring[buffer.next] = event;
+            if (++buffer.next == buffer.ring.size())
+            {
+                buffer.next = 0;
+                buffer.wrapped = true;
+            }
+        }
+
+        /**
+         * @brief Returns a copy of every recorded event, oldest first within each thread.
+         * @param None
+         * @returns The events.
+         * @throw None
+         */
+        std::vector<TraceEvent> events()
+        {
+            std::vector<TraceEvent> all;
+            std::lock_guard<std::mutex> registry_guard(registry_lock);
+            for (size_t b = 0; b < buffers.size(); ++b)
+            {
+                ThreadBuffer &buffer = *buffers[b];
+                std::lock_guard<std::mutex> guard(buffer.lock);
+                if (buffer.wrapped)
+                {
+                    all.insert(all.end(), buffer.ring.begin() + buffer.next, buffer.ring.end());
+                }
+                all.insert(all.end(), buffer.ring.begin(), buffer.ring.begin() + buffer.next);
+            }
+            return all;
+        }
+
+        /**
+         * @brief Drops every recorded event.
+         * @param None
+         * @returns void
+         * @throw None
+         */
+        void clear()
+        {
+            std::lock_guard<std::mutex> registry_guard(registry_lock);
+            for (size_t b = 0; b < buffers.size(); ++b)
+            {
+                std::lock_guard<std::mutex> guard(buffers[b]->lock);
+                buffers[b]->next = 0;
+                buffers[b]->wrapped = false;
+            }
+        }
+
+        /**
+         * @brief Writes every recorded event as a Chrome trace JSON file.
+         *
+         * @note An event whose begin was overwritten in the ring shows up as an unmatched end, which trace viewers ignore.
+         *
+         * @param path The file to write.
+         * @returns void
+         * @throw std::runtime_error if the file cannot be written.
+         */
+        void writeChromeTrace(const std::string &path)
+        {
+            std::vector<TraceEvent> all = events();
+            std::ofstream out(path.c_str());
+            if (!out)
+            {
+                throw std::runtime_error("Cannot open trace file: " + path);
+            }
+            out << std::fixed << std::setprecision(3); // Timestamps are microseconds with ns resolution
+            out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+            for (size_t i = 0; i < all.size(); ++i)
+            {
+                const TraceEvent &event = all[i];
+                out << "{\"name\": \"" << event.name << "\", \"cat\": \"MyContainer\", \"ph\": \"" << event.phase
+                    << "\", \"ts\": " << static_cast<double>(event.nanos) / 1000.0
+                    << ", \"pid\": 1, \"tid\": " << event.thread_id
+                    << ", \"args\": {\"elements\": " << event.count << "}}"
+                    << (i + 1 < all.size() ? ",\n" : "\n");
+            }
+            out << "]}\n";
+            if (!out)
+            {
+                throw std::runtime_error("Cannot write trace file: " + path);
+            }
+        }
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Records a begin event now and the matching end event when it goes out of scope.
+         */
+        class TraceScope
+        {
+        private:
+            const char *name;
+            size_t count;
+
+            TraceScope(const TraceScope &);
+            TraceScope &operator=(const TraceScope &);
+
+        public:
+            /**
+             * @brief Constructor for TraceScope, records the begin event.
+             * @param name Event name, must stay valid until the trace is written.
+             * @param count Number of elements involved.
+             * @returns TraceScope object.
+             * @throw None
+             */
+            TraceScope(const char *name, size_t count) : name(name), count(count)
+            {
+                Tracer::instance().record(name, 'B', count);
+            }
+
+            /**
+             * @brief Destructor, records the end event.
+             * @param None
+             * @returns None
+             * @throw None
+             */
+            ~TraceScope()
+            {
+                Tracer::instance().record(name, 'E', count);
+            }
+        };
+    }
+}
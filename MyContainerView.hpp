@@ -0,0 +1,340 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <cstddef>   // for size_t
+#include <memory>    // for std::shared_ptr
+#include <vector>    // for std::vector
+#include "MyContainer.hpp"
+
+namespace my_cont_ns
+{
+    /**
+     * @brief Read-only, non-owning view that offers the six traversal orders of MyContainer over external memory.
+     * The view wraps a (pointer, length) span, e.g. an mmap'd file or a buffer owned by another library,
+     * and keeps no copy of the elements: ReverseOrder, Order and MiddleOutOrder read the memory in place, and
+     * the sorted orders read it through one ascending index permutation that is built on first use and shared
+     * by every iterator and copy of the view. For a trivially copyable T, building the permutation sorts a
+     * temporary (element, index) copy (see detail::ascendingPermutation()), released once the permutation is
+     * built. When the caller already keeps a sorted copy of the elements (e.g. in shared memory) the sorted
+     * orders read that copy instead and no permutation is built.
+     *
+     * @note The viewed memory must outlive the view and its iterators and must not change while they are used.
+     */
+    template <typename T = int>
+    class MyContainerView
+    {
+    private:
+        const T *elements; // First viewed element
+        size_t count;      // Number of viewed elements
+        const T *sorted;   // Caller-provided ascending copy of the elements, or null
+        mutable detail::SharedSlot<const std::vector<size_t>> permutation_cache; // Ascending permutation, built on first use
+
+        /**
+         * @brief Returns the ascending permutation of the viewed elements, building it on first use.
+         * @param None
+         * @returns The permutation (permutation[i] is the index of the i-th smallest element).
+         * @throw None
+         */
+        std::shared_ptr<const std::vector<size_t>> ascendingPermutation() const
+        {
+            std::shared_ptr<const std::vector<size_t>> cached = permutation_cache.load();
+            if (cached)
+            {
+                return cached;
+            }
+            std::shared_ptr<std::vector<size_t>> permutation = std::make_shared<std::vector<size_t>>();
+            {
+                MYCONTAINER_TRACE_SCOPE("sort", count);
+                detail::ascendingPermutation(elements, count, *permutation);
+            }
+            permutation_cache.store(permutation);
+            return permutation;
+        }
+
+    public:
+        // Default number of elements per span handed out by forEachSpan()
+        static const size_t DEFAULT_SPAN_SIZE = 4096;
+
+        /**
+         * @brief Constructor for MyContainerView.
+         * @param data The first element to view (may be null when size is 0).
+         * @param size Number of elements to view.
+         * @returns MyContainerView object.
+         * @throw None
+         */
+        MyContainerView(const T *data, size_t size) : elements(data), count(size), sorted(NULL) {}
+
+        /**
+         * @brief Constructor for MyContainerView with a precomputed ascending order.
+         * @param data The first element to view (may be null when size is 0).
+         * @param sorted_data The same elements in ascending order, read by the sorted orders.
+         * @param size Number of elements to view.
+         * @returns MyContainerView object.
+         * @throw None
+         */
+        MyContainerView(const T *data, const T *sorted_data, size_t size) : elements(data), count(size), sorted(sorted_data) {}
+
+        /**
+         * @brief Constructor for MyContainerView over a span.
+         * @param span The elements to view.
+         * @returns MyContainerView object.
+         * @throw None
+         */
+        explicit MyContainerView(Span<T> span) : elements(span.data), count(span.size), sorted(NULL) {}
+
+        /**
+         * @brief Constructor for MyContainerView over the elements of a vector.
+         *
+         * @note The view is invalidated by anything that reallocates or modifies the vector.
+         *
+         * @param vector The vector to view.
+         * @returns MyContainerView object.
+         * @throw None
+         */
+        explicit MyContainerView(const std::vector<T> &vector) : elements(vector.data()), count(vector.size()), sorted(NULL) {}
+
+        /**
+         * @brief Returns the number of viewed elements.
+         * @param None
+         * @returns The size of the view.
+         * @throw None
+         */
+        size_t size() const { return count; }
+
+        /**
+         * @brief Checks if the view is empty.
+         * @param None
+         * @returns true if the view has no elements, false otherwise.
+         * @throw None
+         */
+        bool isEmpty() const { return count == 0; }
+
+        /**
+         * @brief Returns the viewed memory.
+         * @param None
+         * @returns Pointer to the first viewed element.
+         * @throw None
+         */
+        const T *data() const { return elements; }
+
+        // == Iterator Class ==
+
+        /**
+         * @brief Iterator over one traversal order of the view.
+         * Every position is mapped to an element in O(1): directly for the insertion-based orders, and through the
+         * shared ascending permutation for the sorted ones.
+         * @tparam Kind The traversal order.
+         */
+        template <OrderKind Kind>
+        class ViewOrder
+        {
+        private:
+            const T *elements;                                     // The viewed memory
+            size_t count;                                          // Number of viewed elements
+            const T *sorted;                                       // Precomputed ascending order, or null
+            std::shared_ptr<const std::vector<size_t>> permutation; // Ascending permutation (sorted orders only)
+            size_t current_index;
+
+            /**
+             * @brief Returns true for the orders that read through the permutation.
+             * @param None
+             * @returns true for AscendingOrder, DescendingOrder and SideCrossOrder.
+             * @throw None
+             */
+            static bool isSorted()
+            {
+                return Kind == OrderKind::AscendingOrder || Kind == OrderKind::DescendingOrder || Kind == OrderKind::SideCrossOrder;
+            }
+
+            /**
+             * @brief Returns the element at a rank of the ascending order.
+             * @param rank Rank in the ascending order.
+             * @returns A constant reference to the element.
+             * @throw None
+             */
+            const T &sortedAt(size_t rank) const
+            {
+                return sorted != NULL ? sorted[rank] : elements[(*permutation)[rank]];
+            }
+
+        public:
+            /**
+             * @brief Constructor for ViewOrder.
+             * @param view The view to iterate over.
+             * @returns ViewOrder object.
+             * @throw None
+             */
+            explicit ViewOrder(const MyContainerView &view)
+                : elements(view.elements), count(view.count), sorted(view.sorted), current_index(0)
+            {
+                if (isSorted() && sorted == NULL)
+                {
+                    permutation = view.ascendingPermutation();
+                }
+            }
+
+            /**
+             * @brief Returns the element at a position of this order.
+             * @param position Position in the order, must be smaller than size().
+             * @returns A constant reference to the element.
+             * @throw None
+             */
+            const T &at(size_t position) const
+            {
+                switch (Kind)
+                {
+                case OrderKind::AscendingOrder:
+                    return sortedAt(position);
+                case OrderKind::DescendingOrder:
+                    return sortedAt(count - 1 - position);
+                case OrderKind::SideCrossOrder:
+                    return sortedAt(detail::sideCrossIndex(position, count));
+                case OrderKind::ReverseOrder:
+                    return elements[count - 1 - position];
+                case OrderKind::MiddleOutOrder:
+                    return elements[detail::middleOutIndex(position, count)];
+                case OrderKind::Order:
+                default:
+                    return elements[position];
+                }
+            }
+
+            /**
+             * @brief Returns the number of elements in the order.
+             * @param None
+             * @returns The size of the order.
+             * @throw None
+             */
+            size_t size() const { return count; }
+
+            /**
+             * @brief Pre-increment operator for the ViewOrder iterator.
+             * @param None
+             * @returns Reference to the current ViewOrder object after incrementing.
+             * @throw None
+             */
+            ViewOrder &operator++()
+            {
+                ++current_index;
+                return *this;
+            }
+
+            /**
+             * @brief Post-increment operator for the ViewOrder iterator.
+             * @param None
+             * @returns A copy of the ViewOrder object before incrementing.
+             * @throw None
+             */
+            ViewOrder operator++(int)
+            {
+                ViewOrder temp = *this;
+                ++current_index;
+                return temp;
+            }
+
+            /**
+             * @brief Dereference operator for the ViewOrder iterator.
+             * @param None
+             * @returns A constant reference to the current element.
+             * @throw std::out_of_range if the current index exceeds the number of elements (see MYCONTAINER_ITERATOR_CHECKS).
+             */
+            const T &operator*() const
+            {
+                detail::checkIteratorIndex(current_index, count);
+                return at(current_index);
+            }
+
+            /**
+             * @brief Equality operator for the ViewOrder iterator.
+             * @param other Another ViewOrder iterator to compare with.
+             * @returns true if both iterators point to the same index, false otherwise.
+             * @throw None
+             */
+            bool operator==(const ViewOrder &other) const
+            {
+                return current_index == other.current_index;
+            }
+
+            /**
+             * @brief Inequality operator for the ViewOrder iterator.
+             * @param other Another ViewOrder iterator to compare with.
+             * @returns true if the iterators point to different indices, false otherwise.
+             * @throw None
+             */
+            bool operator!=(const ViewOrder &other) const
+            {
+                return !(*this == other);
+            }
+
+            /**
+             * @brief Begin method for the ViewOrder iterator.
+             * @param None
+             * @returns A new ViewOrder iterator starting from the first element.
+             * @throw None
+             */
+            ViewOrder begin() const
+            {
+                ViewOrder iter = *this;
+                iter.current_index = 0;
+                return iter;
+            }
+
+            /**
+             * @brief End method for the ViewOrder iterator.
+             * @param None
+             * @returns A new ViewOrder iterator pointing to one past the last element.
+             * @throw None
+             */
+            ViewOrder end() const
+            {
+                ViewOrder iter = *this;
+                iter.current_index = count;
+                return iter;
+            }
+
+            /**
+             * @brief Hands out the order in contiguous spans.
+             *
+             * @note Order spans point into the viewed memory; the other orders gather each span into a buffer
+             * that is only valid during the call.
+             *
+             * @param fn Callable invoked as fn(Span<T>) once per chunk, in traversal order.
+             * @param chunk_size Maximum number of elements per span.
+             * @returns void
+             * @throw std::invalid_argument if chunk_size is 0.
+             */
+            template <typename Function>
+            void forEachSpan(Function fn, size_t chunk_size = DEFAULT_SPAN_SIZE) const
+            {
+                if (Kind == OrderKind::Order)
+                {
+                    detail::forEachSpanOf(elements, count, chunk_size, fn);
+                    return;
+                }
+                const ViewOrder *self = this;
+                detail::forEachGatheredSpan<T>(count, chunk_size, fn, [self](size_t i) -> const T & { return self->at(i); });
+            }
+        };
+
+        typedef ViewOrder<OrderKind::AscendingOrder> AscendingOrder;
+        typedef ViewOrder<OrderKind::DescendingOrder> DescendingOrder;
+        typedef ViewOrder<OrderKind::SideCrossOrder> SideCrossOrder;
+        typedef ViewOrder<OrderKind::ReverseOrder> ReverseOrder;
+        typedef ViewOrder<OrderKind::Order> Order;
+        typedef ViewOrder<OrderKind::MiddleOutOrder> MiddleOutOrder;
+
+        // == Iterator factory methods, same semantics as MyContainer's ==
+
+        AscendingOrder getAscendingOrder() const { return AscendingOrder(*this); }
+
+        DescendingOrder getDescendingOrder() const { return DescendingOrder(*this); }
+
+        SideCrossOrder getSideCrossOrder() const { return SideCrossOrder(*this); }
+
+        ReverseOrder getReverseOrder() const { return ReverseOrder(*this); }
+
+        Order getOrder() const { return Order(*this); }
+
+        MiddleOutOrder getMiddleOutOrder() const { return MiddleOutOrder(*this); }
+    };
+}
@@ -0,0 +1,1113 @@
+// yarinkash1@gmail.com
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <future>
+#include "MyContainer.hpp"
+#include "MyContainerSharded.hpp"
+#include "MyContainerParallel.hpp"
+#include "pgo_workload.hpp"
+
+using namespace my_cont_ns;
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Receives checksums so the measured work cannot be optimized away
+    volatile long long benchmark_sink = 0;
+
+    /**
+     * @brief Command line configuration of the benchmark run.
+     */
+    struct BenchConfig
+    {
+        size_t max_size;       // Largest container size of the suite (sizes go 10, 100, ..., max_size)
+        int repetitions;       // Samples per measurement
+        std::string json_path; // Where the machine-readable results are written
+        std::string section;   // "all", "suite", "topk", "traversal", "format", "io", "ingest", "merge", "sharded", "scaling", "background", "async" or "generator"
+    };
+
+    /**
+     * @brief One aggregated measurement of the suite.
+     */
+    struct BenchResult
+    {
+        std::string type;      // Element type name
+        size_t size;           // Container size
+        std::string operation; // Measured operation
+        double median_ns;      // Median over the repetitions
+        double p99_ns;         // 99th percentile (nearest rank) over the repetitions
+        int samples;           // Number of repetitions
+    };
+
+    /**
+     * @brief Returns the milliseconds elapsed since the given start point.
+     * @param start The time point to measure from.
+     * @returns Elapsed milliseconds.
+     * @throw None
+     */
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Returns the nanoseconds elapsed since the given start point.
+     * @param start The time point to measure from.
+     * @returns Elapsed nanoseconds.
+     * @throw None
+     */
+    double elapsedNs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Returns the value at the given percentile (nearest rank).
+     * @param samples The samples, sorted in place.
+     * @param percentile Percentile in [0, 100].
+     * @returns The selected sample, 0 for no samples.
+     * @throw None
+     */
+    double percentileOf(std::vector<double> &samples, double percentile)
+    {
+        if (samples.empty())
+        {
+            return 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        size_t rank = static_cast<size_t>(percentile / 100.0 * samples.size() + 0.999999);
+        rank = std::max<size_t>(1, std::min(rank, samples.size()));
+        return samples[rank - 1];
+    }
+
+    // == Element generators and sinks per element type ==
+
+    void generate(std::mt19937 &rng, int &out) { out = static_cast<int>(rng()); }
+
+    void generate(std::mt19937 &rng, double &out) { out = static_cast<double>(rng()) / 7.0; }
+
+    void generate(std::mt19937 &rng, char &out) { out = static_cast<char>('!' + rng() % 94); }
+
+    void generate(std::mt19937 &rng, std::string &out)
+    {
+        out.assign(8, ' ');
+        for (size_t i = 0; i < out.size(); ++i)
+        {
+            out[i] = static_cast<char>('a' + rng() % 26);
+        }
+    }
+
+    // Folds an element into a checksum so the traversal cannot be optimized away
+    long long touch(int value) { return value; }
+
+    long long touch(double value) { return static_cast<long long>(value); }
+
+    long long touch(char value) { return value; }
+
+    long long touch(const std::string &value) { return static_cast<long long>(value.size()) + value[0]; }
+
+    /**
+     * @brief Traverses an order through its iterator interface.
+     * @param order The iterator object to traverse.
+     * @returns Checksum of all elements.
+     * @throw None
+     */
+    template <typename Iterator>
+    long long traverse(Iterator order)
+    {
+        long long sum = 0;
+        for (auto it = order.begin(), end = order.end(); it != end; ++it)
+        {
+            sum += touch(*it);
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Collects samples of one operation and stores the aggregated result.
+     */
+    class Recorder
+    {
+    private:
+        std::vector<BenchResult> &results;
+        std::string type;
+        size_t size;
+
+    public:
+        Recorder(std::vector<BenchResult> &results, const std::string &type, size_t size)
+            : results(results), type(type), size(size) {}
+
+        /**
+         * @brief Aggregates the samples of one operation, prints a row and stores the result.
+         * @param operation Name of the measured operation.
+         * @param samples The raw samples in nanoseconds (sorted in place).
+         * @returns void
+         * @throw None
+         */
+        void record(const std::string &operation, std::vector<double> &samples)
+        {
+            BenchResult result;
+            result.type = type;
+            result.size = size;
+            result.operation = operation;
+            result.samples = static_cast<int>(samples.size());
+            result.median_ns = percentileOf(samples, 50);
+            result.p99_ns = percentileOf(samples, 99);
+            results.push_back(result);
+            std::cout << std::setw(8) << type << std::setw(10) << size << std::setw(18) << operation
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(16) << result.median_ns << std::setw(16) << result.p99_ns << std::endl;
+        }
+    };
+
+    /**
+     * @brief Measures construction plus full traversal of one order.
+     * @param recorder Where the result goes.
+     * @param operation Name of the order.
+     * @param repetitions Number of samples.
+     * @param make Callable returning a fresh iterator object.
+     * @param sink Checksum accumulator.
+     * @returns void
+     * @throw None
+     */
+    template <typename Factory>
+    void benchOrder(Recorder &recorder, const std::string &operation, int repetitions, Factory make, long long &sink)
+    {
+        std::vector<double> samples;
+        for (int rep = 0; rep < repetitions; ++rep)
+        {
+            Clock::time_point start = Clock::now();
+            sink += traverse(make());
+            samples.push_back(elapsedNs(start));
+        }
+        recorder.record(operation, samples);
+    }
+
+    /**
+     * @brief Runs every operation of the suite for one element type and one size.
+     * add is reported per call, remove per call on a fresh copy, and each order as construction plus full traversal.
+     * @param type_name Name of T for the report.
+     * @param size Container size.
+     * @param config The run configuration.
+     * @param results Where the results are appended.
+     * @returns void
+     * @throw None
+     */
+    template <typename T>
+    void benchTypeAtSize(const std::string &type_name, size_t size, const BenchConfig &config, std::vector<BenchResult> &results)
+    {
+        std::mt19937 rng(static_cast<unsigned>(size * 31 + type_name.size()));
+        std::vector<T> input(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            generate(rng, input[i]);
+        }
+
+        Recorder recorder(results, type_name, size);
+        long long sink = 0;
+        MyContainer<T> container;
+
+        std::vector<double> samples;
+        for (int rep = 0; rep < config.repetitions; ++rep)
+        {
+            MyContainer<T> fresh;
+            Clock::time_point start = Clock::now();
+            for (size_t i = 0; i < size; ++i)
+            {
+                fresh.add(input[i]);
+            }
+            samples.push_back(elapsedNs(start) / static_cast<double>(size));
+            if (rep == 0)
+            {
+                container = fresh;
+            }
+        }
+        recorder.record("add", samples);
+
+        samples.clear();
+        for (int rep = 0; rep < config.repetitions; ++rep)
+        {
+            MyContainer<T> copy = container;
+            const T victim = input[(rep * 7919) % size];
+            Clock::time_point start = Clock::now();
+            copy.remove(victim);
+            samples.push_back(elapsedNs(start));
+            sink += static_cast<long long>(copy.size());
+        }
+        recorder.record("remove", samples);
+
+        benchOrder(recorder, "AscendingOrder", config.repetitions, [&]() { return container.getAscendingOrder(); }, sink);
+        benchOrder(recorder, "DescendingOrder", config.repetitions, [&]() { return container.getDescendingOrder(); }, sink);
+        benchOrder(recorder, "SideCrossOrder", config.repetitions, [&]() { return container.getSideCrossOrder(); }, sink);
+        benchOrder(recorder, "ReverseOrder", config.repetitions, [&]() { return container.getReverseOrder(); }, sink);
+        benchOrder(recorder, "Order", config.repetitions, [&]() { return container.getOrder(); }, sink);
+        benchOrder(recorder, "MiddleOutOrder", config.repetitions, [&]() { return container.getMiddleOutOrder(); }, sink);
+
+        benchmark_sink += sink;
+    }
+
+    /**
+     * @brief Runs the full suite: add, remove and all six orders for int, double, char and std::string.
+     * @param config The run configuration.
+     * @param results Where the results are appended.
+     * @returns void
+     * @throw None
+     */
+    void benchSuite(const BenchConfig &config, std::vector<BenchResult> &results)
+    {
+        std::cout << "== Suite (" << config.repetitions << " repetitions, times in ns) ==" << std::endl;
+        std::cout << std::setw(8) << "type" << std::setw(10) << "size" << std::setw(18) << "operation"
+                  << std::setw(16) << "median" << std::setw(16) << "p99" << std::endl;
+        for (size_t size = 10; size <= config.max_size; size *= 10)
+        {
+            benchTypeAtSize<int>("int", size, config, results);
+            benchTypeAtSize<double>("double", size, config, results);
+            benchTypeAtSize<char>("char", size, config, results);
+            benchTypeAtSize<std::string>("string", size, config, results);
+        }
+
+        // One number per run, so build profiles can be compared at a glance
+        double score_ms = 0;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            score_ms += results[i].median_ns / 1e6;
+        }
+        std::cout << "Suite score (sum of medians): " << std::fixed << std::setprecision(3) << score_ms << " ms" << std::endl;
+    }
+
+    /**
+     * @brief Builds an iterator and reads its first k elements.
+     * @param order The iterator object to read from.
+     * @param k Number of elements to read.
+     * @returns Sum of the elements read (keeps the work observable).
+     * @throw None
+     */
+    template <typename Iterator>
+    long long readFirst(Iterator order, size_t k)
+    {
+        long long sum = 0;
+        size_t read = 0;
+        for (auto it = order.begin(), end = order.end(); it != end && read < k; ++it, ++read)
+        {
+            sum += *it;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Compares the eager and the lazy AscendingOrder when reading only the first k elements.
+     * Prints one row per k and reports the first k at which the full sort wins.
+     * @param n Number of elements in the container.
+     * @returns void
+     * @throw None
+     */
+    void benchTopK(size_t n)
+    {
+        MyContainer<int> container;
+        std::mt19937 rng(12345);
+        for (size_t i = 0; i < n; ++i)
+        {
+            container.add(static_cast<int>(rng()));
+        }
+
+        std::cout << "== Top-K AscendingOrder, n = " << n << " ==" << std::endl;
+        std::cout << std::setw(10) << "k" << std::setw(14) << "eager [ms]" << std::setw(14) << "lazy [ms]" << std::endl;
+
+        size_t crossover = 0;
+        long long sink = 0;
+        for (size_t k = 1; k <= n; k *= 10)
+        {
+            Clock::time_point start = Clock::now();
+            sink += readFirst(container.getAscendingOrder(), k);
+            double eager = elapsedMs(start);
+
+            start = Clock::now();
+            sink += readFirst(container.getLazyAscendingOrder(), k);
+            double lazy = elapsedMs(start);
+
+            if (crossover == 0 && lazy >= eager)
+            {
+                crossover = k;
+            }
+            std::cout << std::setw(10) << k << std::fixed << std::setprecision(3)
+                      << std::setw(14) << eager << std::setw(14) << lazy << std::endl;
+        }
+
+        if (crossover == 0)
+        {
+            std::cout << "Lazy mode was faster for every k" << std::endl;
+        }
+        else
+        {
+            std::cout << "Full sort wins from k = " << crossover << std::endl;
+        }
+        std::cout << "(checksum " << sink << ")" << std::endl;
+    }
+
+    /**
+     * @brief Sums an order through its iterator interface.
+     * @param order The iterator object to traverse.
+     * @returns Sum of all elements.
+     * @throw None
+     */
+    template <typename Iterator>
+    long long sumOrder(Iterator &order)
+    {
+        long long sum = 0;
+        for (auto it = order.begin(), end = order.end(); it != end; ++it)
+        {
+            sum += *it;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Measures the iterator traversal loop against a plain array loop.
+     * Build once with the default checks and once with MYCONTAINER_ITERATOR_CHECKS=0
+     * (make bench-unchecked) to see the cost of the bounds check in operator*.
+     * @param n Number of elements in the container.
+     * @returns void
+     * @throw None
+     */
+    void benchTraversal(size_t n)
+    {
+        MyContainer<int> container;
+        for (size_t i = 0; i < n; ++i)
+        {
+            container.add(static_cast<int>(i % 1000));
+        }
+        auto order = container.getOrder();
+        auto ascending = container.getAscendingOrder();
+        const std::vector<int> &raw = container.getElements();
+
+        const int repetitions = 5;
+        double best_order = 1e300;
+        double best_ascending = 1e300;
+        double best_raw = 1e300;
+        long long sink = 0;
+        for (int rep = 0; rep < repetitions; ++rep)
+        {
+            Clock::time_point start = Clock::now();
+            sink += sumOrder(order);
+            best_order = std::min(best_order, elapsedMs(start));
+
+            start = Clock::now();
+            sink += sumOrder(ascending);
+            best_ascending = std::min(best_ascending, elapsedMs(start));
+
+            start = Clock::now();
+            long long sum = 0;
+            for (size_t i = 0; i < raw.size(); ++i)
+            {
+                sum += raw[i];
+            }
+            sink += sum;
+            best_raw = std::min(best_raw, elapsedMs(start));
+        }
+
+        std::cout << "== Traversal, n = " << n << ", MYCONTAINER_ITERATOR_CHECKS = " << MYCONTAINER_ITERATOR_CHECKS << " ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "   Order iterator:          " << best_order << " ms" << std::endl;
+        std::cout << "   AscendingOrder iterator: " << best_ascending << " ms" << std::endl;
+        std::cout << "   Plain array loop:        " << best_raw << " ms" << std::endl;
+        std::cout << "(checksum " << sink << ")" << std::endl;
+    }
+
+    /**
+     * @brief Times writing a container to a string stream with operator<< against streaming each element.
+     * @param type_name Element type name for the report.
+     * @param container The container to write.
+     * @returns void
+     * @throw None
+     */
+    template <typename T>
+    void benchFormatType(const std::string &type_name, const MyContainer<T> &container)
+    {
+        const int repetitions = 5;
+        double best_engine = 1e300;
+        double best_per_element = 1e300;
+        size_t bytes = 0;
+        for (int rep = 0; rep < repetitions; ++rep)
+        {
+            std::ostringstream engine;
+            Clock::time_point start = Clock::now();
+            engine << container;
+            best_engine = std::min(best_engine, elapsedMs(start));
+            bytes = engine.str().size();
+
+            std::ostringstream per_element;
+            start = Clock::now();
+            const std::vector<T> &elements = container.getElements();
+            for (size_t i = 0; i < elements.size(); ++i)
+            {
+                per_element << elements[i] << " ";
+            }
+            best_per_element = std::min(best_per_element, elapsedMs(start));
+            benchmark_sink += static_cast<long long>(per_element.str().size());
+        }
+        std::cout << "   " << std::setw(7) << type_name << ": operator<< " << best_engine << " ms, per-element << "
+                  << best_per_element << " ms, " << std::setprecision(1)
+                  << static_cast<double>(bytes) / (1024.0 * 1024.0) / (best_engine / 1000.0) << " MiB/s"
+                  << std::setprecision(3) << std::endl;
+    }
+
+    /**
+     * @brief Measures the buffered formatting of operator<< for the element types of the suite.
+     * @param n Number of elements per container.
+     * @returns void
+     * @throw None
+     */
+    void benchFormat(size_t n)
+    {
+        std::mt19937 generator(7);
+        std::uniform_int_distribution<int> ints(-1000000000, 1000000000);
+        std::uniform_real_distribution<double> doubles(-1e6, 1e6);
+        MyContainer<int> int_container;
+        MyContainer<double> double_container;
+        MyContainer<std::string> string_container;
+        for (size_t i = 0; i < n; ++i)
+        {
+            int value = ints(generator);
+            int_container.add(value);
+            double_container.add(doubles(generator));
+            string_container.add("item" + std::to_string(value % 10000));
+        }
+
+        std::cout << "== Formatting, n = " << n << " ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        benchFormatType("int", int_container);
+        benchFormatType("double", double_container);
+        benchFormatType("string", string_container);
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Compares rebuilding a container with add() against save() + load(),
+     * and the first sorted read after loading with and without the persisted sorted index.
+     * @param n Number of elements.
+     * @returns void
+     * @throw std::runtime_error if the temporary file cannot be written.
+     */
+    void benchPersistence(size_t n)
+    {
+        const std::string path = "bench_tmp_container.bin";
+        std::vector<int> source(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            source[i] = static_cast<int>((i * 2654435761u) % 1000003);
+        }
+
+        Clock::time_point start = Clock::now();
+        MyContainer<int> rebuilt;
+        for (size_t i = 0; i < n; ++i)
+        {
+            rebuilt.add(source[i]);
+        }
+        double add_ms = elapsedMs(start);
+
+        start = Clock::now();
+        rebuilt.save(path);
+        double save_ms = elapsedMs(start);
+
+        start = Clock::now();
+        MyContainer<int> loaded;
+        loaded.load(path);
+        double load_ms = elapsedMs(start);
+        start = Clock::now();
+        benchmark_sink += *loaded.getAscendingOrder().begin();
+        double first_sorted_ms = elapsedMs(start);
+
+        start = Clock::now();
+        rebuilt.save(path, true);
+        double indexed_save_ms = elapsedMs(start);
+
+        start = Clock::now();
+        MyContainer<int> indexed;
+        indexed.load(path);
+        double indexed_load_ms = elapsedMs(start);
+        start = Clock::now();
+        benchmark_sink += *indexed.getAscendingOrder().begin();
+        double indexed_first_sorted_ms = elapsedMs(start);
+        std::remove(path.c_str());
+
+        std::cout << "== Persistence, n = " << n << " ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "   add() rebuild:                 " << add_ms << " ms" << std::endl;
+        std::cout << "   save():                        " << save_ms << " ms" << std::endl;
+        std::cout << "   load():                        " << load_ms << " ms" << std::endl;
+        std::cout << "   first getAscendingOrder():     " << first_sorted_ms << " ms" << std::endl;
+        std::cout << "   save() with sorted index:      " << indexed_save_ms << " ms" << std::endl;
+        std::cout << "   load() with sorted index:      " << indexed_load_ms << " ms" << std::endl;
+        std::cout << "   first getAscendingOrder() after it: " << indexed_first_sorted_ms << " ms" << std::endl;
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Compares populating a container from text with an operator>> + add() loop against ingest()
+     * and ingestFile() with one and several parsing threads.
+     * @param n Number of elements.
+     * @returns void
+     * @throw std::runtime_error if the temporary file cannot be written.
+     */
+    void benchIngest(size_t n)
+    {
+        const std::string path = "bench_tmp_ingest.txt";
+        std::ostringstream text;
+        for (size_t i = 0; i < n; ++i)
+        {
+            text << static_cast<int>((i * 2654435761u) % 2000003) - 1000000 << (i % 16 == 15 ? '\n' : ' ');
+        }
+        const std::string content = text.str();
+        {
+            std::ofstream file(path.c_str());
+            file << content;
+        }
+
+        Clock::time_point start = Clock::now();
+        MyContainer<int> looped;
+        std::istringstream loop_in(content);
+        int value;
+        while (loop_in >> value)
+        {
+            looped.add(value);
+        }
+        double loop_ms = elapsedMs(start);
+
+        start = Clock::now();
+        MyContainer<int> streamed;
+        std::istringstream ingest_in(content);
+        streamed.ingest(ingest_in);
+        double ingest_ms = elapsedMs(start);
+
+        unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+        start = Clock::now();
+        MyContainer<int> mapped;
+        mapped.ingestFile(path);
+        double file_ms = elapsedMs(start);
+        start = Clock::now();
+        MyContainer<int> parallel;
+        parallel.ingestFile(path, threads);
+        double parallel_ms = elapsedMs(start);
+        std::remove(path.c_str());
+        benchmark_sink += looped.size() + streamed.size() + mapped.size() + parallel.size();
+
+        std::cout << "== Text ingest, n = " << n << " (" << content.size() / 1024 << " KiB) ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "   operator>> + add() loop:       " << loop_ms << " ms" << std::endl;
+        std::cout << "   ingest(istream):               " << ingest_ms << " ms" << std::endl;
+        std::cout << "   ingestFile():                  " << file_ms << " ms" << std::endl;
+        std::cout << "   ingestFile(), " << threads << " threads:     " << parallel_ms << " ms" << std::endl;
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Compares one global ascending pass over sharded data: concatenating the shards into a new container
+     * and sorting it, against mergeAscending() over the shards with cold and with warm sort caches.
+     * @param n Total number of elements.
+     * @param shards Number of containers the elements are spread over.
+     * @returns void
+     * @throw None
+     */
+    void benchMerge(size_t n, size_t shards)
+    {
+        std::vector<MyContainer<int>> parts(shards);
+        for (size_t i = 0; i < n; ++i)
+        {
+            parts[i % shards].add(static_cast<int>((i * 2654435761u) % 1000003));
+        }
+        std::vector<const MyContainer<int> *> pointers;
+        for (size_t s = 0; s < shards; ++s)
+        {
+            pointers.push_back(&parts[s]);
+        }
+
+        Clock::time_point start = Clock::now();
+        MyContainer<int> concatenated;
+        for (size_t s = 0; s < shards; ++s)
+        {
+            for (int value : parts[s].getOrder())
+            {
+                concatenated.add(value);
+            }
+        }
+        for (int value : concatenated.getAscendingOrder())
+        {
+            benchmark_sink += static_cast<size_t>(value);
+        }
+        double concat_ms = elapsedMs(start);
+
+        start = Clock::now();
+        for (int value : mergeAscending(pointers)) // Sorts every shard once
+        {
+            benchmark_sink += static_cast<size_t>(value);
+        }
+        double cold_ms = elapsedMs(start);
+
+        start = Clock::now();
+        for (int value : mergeAscending(pointers))
+        {
+            benchmark_sink += static_cast<size_t>(value);
+        }
+        double warm_ms = elapsedMs(start);
+
+        std::cout << "== Global ascending pass over " << shards << " shards, n = " << n << " ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "   concatenate + sort:            " << concat_ms << " ms" << std::endl;
+        std::cout << "   mergeAscending(), cold caches: " << cold_ms << " ms" << std::endl;
+        std::cout << "   mergeAscending(), warm caches: " << warm_ms << " ms" << std::endl;
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Compares one MyContainer against a ShardedMyContainer: bulk add, remove() and count() of present values,
+     * and building the sorted order.
+     * @param n Number of elements.
+     * @param shards Number of shards.
+     * @returns void
+     * @throw None
+     */
+    void benchSharded(size_t n, size_t shards)
+    {
+        std::vector<int> values(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            values[i] = static_cast<int>((i * 2654435761u) % 1000003);
+        }
+        const size_t removals = 100;
+
+        Clock::time_point start = Clock::now();
+        MyContainer<int> single;
+        for (int value : values)
+        {
+            single.add(value);
+        }
+        double single_add_ms = elapsedMs(start);
+        start = Clock::now();
+        for (size_t r = 0; r < removals; ++r)
+        {
+            benchmark_sink += single.count(values[r * 7]);
+            single.remove(values[r * 7]);
+        }
+        double single_remove_ms = elapsedMs(start);
+        start = Clock::now();
+        benchmark_sink += *single.getAscendingOrder().begin();
+        double single_sort_ms = elapsedMs(start);
+
+        start = Clock::now();
+        ShardedMyContainer<int> sharded(shards);
+        sharded.addAll(values);
+        double sharded_add_ms = elapsedMs(start);
+        start = Clock::now();
+        for (size_t r = 0; r < removals; ++r)
+        {
+            benchmark_sink += sharded.count(values[r * 7]);
+            sharded.remove(values[r * 7]);
+        }
+        double sharded_remove_ms = elapsedMs(start);
+        start = Clock::now();
+        benchmark_sink += *sharded.getAscendingOrder().begin();
+        double sharded_sort_ms = elapsedMs(start);
+
+        std::cout << "== Sharded container, " << shards << " shards, n = " << n << " ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "   add (single) / addAll (sharded):  " << single_add_ms << " / " << sharded_add_ms << " ms" << std::endl;
+        std::cout << "   count + remove, " << removals << " values:       " << single_remove_ms << " / " << sharded_remove_ms << " ms" << std::endl;
+        std::cout << "   first ascending element:          " << single_sort_ms << " / " << sharded_sort_ms << " ms" << std::endl;
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Measures how the thread pool scales: parallel merge sort and a parallelFor reduction of n elements,
+     * on pools of 1 .. max_threads threads (the calling thread plus max_threads - 1 workers).
+     * @param n Number of elements.
+     * @param max_threads Largest pool to measure.
+     * @returns void
+     * @throw None
+     */
+    void benchScaling(size_t n, size_t max_threads)
+    {
+        std::vector<int> source(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            source[i] = static_cast<int>((i * 2654435761u) % 1000003);
+        }
+        std::cout << "== Thread pool scaling, n = " << n << " (" << std::thread::hardware_concurrency()
+                  << " hardware threads) ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        MyContainer<int> container;
+        for (size_t i = 0; i < n; ++i)
+        {
+            container.add(source[i]);
+        }
+        MyContainer<int>::MiddleOutOrder order = container.getMiddleOutOrder();
+        double sort_base = 0;
+        double sum_base = 0;
+        double each_base = 0;
+        for (size_t threads = 1; threads <= max_threads; ++threads)
+        {
+            ThreadPool pool(threads - 1);
+            std::vector<int> values = source;
+            Clock::time_point start = Clock::now();
+            detail::parallelSort(pool, values.begin(), values.end(), std::less<int>());
+            double sort_ms = elapsedMs(start);
+            benchmark_sink += static_cast<size_t>(values[n / 2]);
+
+            std::atomic<unsigned long long> total(0);
+            start = Clock::now();
+            pool.parallelFor(0, n, 4096, [&source, &total](size_t first, size_t last)
+                             {
+                                 unsigned long long sum = 0;
+                                 for (size_t i = first; i < last; ++i)
+                                 {
+                                     sum += static_cast<unsigned long long>(source[i]) * source[i] % 977;
+                                 }
+                                 total.fetch_add(sum, std::memory_order_relaxed); });
+            double sum_ms = elapsedMs(start);
+            benchmark_sink += total.load();
+
+            // Heavy per-element work over an order: the case parallelForEach() is meant for
+            start = Clock::now();
+            unsigned long long mixed = parallelReduce(
+                order, 0ULL, [](unsigned long long total, const int &value)
+                {
+                    unsigned long long x = static_cast<unsigned long long>(value);
+                    for (int round = 0; round < 64; ++round)
+                    {
+                        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+                    }
+                    return total + (x >> 33); },
+                [](unsigned long long a, unsigned long long b)
+                { return a + b; },
+                DEFAULT_PARALLEL_GRAIN, pool);
+            double each_ms = elapsedMs(start);
+            benchmark_sink += mixed;
+
+            if (threads == 1)
+            {
+                sort_base = sort_ms;
+                sum_base = sum_ms;
+                each_base = each_ms;
+            }
+            std::cout << "   " << threads << " thread(s): parallelSort " << sort_ms << " ms (x" << sort_base / sort_ms
+                      << "), parallelFor " << sum_ms << " ms (x" << sum_base / sum_ms
+                      << "), parallelReduce " << each_ms << " ms (x" << each_base / each_ms << ")" << std::endl;
+        }
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Measures the reader latency of the first sorted traversal after a burst of add() calls, with the
+     * reader sorting by itself versus the sort cache rebuilt by background sorting during an idle gap.
+     * @param n Number of elements added per burst.
+     * @param bursts Number of burst + read rounds.
+     * @returns void
+     * @throw None
+     */
+    void benchBackground(size_t n, size_t bursts)
+    {
+        double latency_ms[2] = {0, 0};
+        for (int background = 0; background < 2; ++background)
+        {
+            MyContainer<int> container;
+            if (background)
+            {
+                container.enableBackgroundSort();
+            }
+            for (size_t burst = 0; burst < bursts; ++burst)
+            {
+                for (size_t i = 0; i < n / bursts; ++i)
+                {
+                    container.add(static_cast<int>(((burst * n + i) * 2654435761u) % 1000003));
+                }
+                // Idle gap between the writes and the next reader, as in a request-driven service
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                container.waitForBackgroundSort(); // Stretches the gap if the rebuild needs longer
+                Clock::time_point start = Clock::now();
+                MyContainer<int>::AscendingOrder order = container.getAscendingOrder();
+                benchmark_sink += static_cast<size_t>(*order.begin());
+                latency_ms[background] += elapsedMs(start);
+            }
+        }
+        std::cout << "== First sorted read after a burst of " << n / bursts << " adds (mean of " << bursts << " bursts) ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "   reader sorts:            " << latency_ms[0] / bursts << " ms" << std::endl;
+        std::cout << "   enableBackgroundSort():  " << latency_ms[1] / bursts << " ms" << std::endl;
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Measures a request that needs the ascending order and waits for unrelated I/O: building the order
+     * first and then waiting, versus getAscendingOrderAsync() overlapping the sort with the wait.
+     * @param n Number of elements.
+     * @param io_wait Duration of the simulated I/O.
+     * @returns void
+     * @throw None
+     */
+    void benchAsync(size_t n, std::chrono::milliseconds io_wait)
+    {
+        std::vector<int> values(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            values[i] = static_cast<int>((i * 2654435761u) % 1000003);
+        }
+        MyContainer<int> blocking;
+        MyContainer<int> overlapped;
+        for (size_t i = 0; i < n; ++i)
+        {
+            blocking.add(values[i]);
+            overlapped.add(values[i]);
+        }
+
+        Clock::time_point start = Clock::now();
+        MyContainer<int>::AscendingOrder order = blocking.getAscendingOrder();
+        std::this_thread::sleep_for(io_wait);
+        benchmark_sink += static_cast<size_t>(*order.begin());
+        double blocking_ms = elapsedMs(start);
+
+        start = Clock::now();
+        std::future<MyContainer<int>::AscendingOrder> pending = overlapped.getAscendingOrderAsync();
+        std::this_thread::sleep_for(io_wait);
+        benchmark_sink += static_cast<size_t>(*pending.get().begin());
+        double async_ms = elapsedMs(start);
+
+        std::cout << "== Sorted order plus " << io_wait.count() << " ms of I/O, n = " << n << " ("
+                  << ThreadPool::instance().workerCount() << " pool workers) ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "   sort, then I/O:             " << blocking_ms << " ms" << std::endl;
+        std::cout << "   getAscendingOrderAsync():   " << async_ms << " ms" << std::endl;
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Reads the first k elements of one order from a fresh iterator or from a generator.
+     * @param container The container; its sort cache is dropped before the timing.
+     * @param kind The order.
+     * @param k Number of elements to read (n reads the whole order).
+     * @param use_generator true to read through generate(), false through the eager iterator.
+     * @returns Elapsed time in milliseconds.
+     * @throw None
+     */
+    double timePrefix(MyContainer<int> &container, OrderKind kind, size_t k, bool use_generator)
+    {
+        container.add(0); // Drops the sort cache, so both sides start cold
+        container.remove(0);
+        Clock::time_point start = Clock::now();
+        if (use_generator)
+        {
+            benchmark_sink += static_cast<size_t>(readFirst(container.generate(kind), k));
+        }
+        else
+        {
+            switch (kind)
+            {
+            case OrderKind::AscendingOrder:
+                benchmark_sink += static_cast<size_t>(readFirst(container.getAscendingOrder(), k));
+                break;
+            case OrderKind::DescendingOrder:
+                benchmark_sink += static_cast<size_t>(readFirst(container.getDescendingOrder(), k));
+                break;
+            case OrderKind::SideCrossOrder:
+                benchmark_sink += static_cast<size_t>(readFirst(container.getSideCrossOrder(), k));
+                break;
+            case OrderKind::ReverseOrder:
+                benchmark_sink += static_cast<size_t>(readFirst(container.getReverseOrder(), k));
+                break;
+            case OrderKind::Order:
+                benchmark_sink += static_cast<size_t>(readFirst(container.getOrder(), k));
+                break;
+            case OrderKind::MiddleOutOrder:
+                benchmark_sink += static_cast<size_t>(readFirst(container.getMiddleOutOrder(), k));
+                break;
+            }
+        }
+        return elapsedMs(start);
+    }
+
+    /**
+     * @brief Compares generate() with the eager iterators, for consumers that read k elements and for full traversals.
+     * @param n Number of elements.
+     * @param k Length of the early-stopping prefix.
+     * @returns void
+     * @throw None
+     */
+    void benchGenerator(size_t n, size_t k)
+    {
+        MyContainer<int> container;
+        for (size_t i = 0; i < n; ++i)
+        {
+            container.add(static_cast<int>((i * 2654435761u) % 1000003 + 1)); // No zeros: timePrefix() adds and removes 0
+        }
+        std::cout << "== generate() vs eager iterators, n = " << n << ", cold sort cache ==" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        for (size_t kind = 0; kind < 6; ++kind)
+        {
+            OrderKind order = static_cast<OrderKind>(kind);
+            std::cout << "   " << std::left << std::setw(16) << ContainerStats::iteratorName(kind) << std::right
+                      << " first " << k << ": eager " << timePrefix(container, order, k, false)
+                      << " ms, generator " << timePrefix(container, order, k, true)
+                      << " ms | full: eager " << timePrefix(container, order, n, false)
+                      << " ms, generator " << timePrefix(container, order, n, true) << " ms" << std::endl;
+        }
+        std::cout.unsetf(std::ios_base::floatfield);
+    }
+
+    /**
+     * @brief Writes the suite results as JSON.
+     * @param config The run configuration.
+     * @param results The aggregated results.
+     * @returns true on success, false if the file could not be written.
+     * @throw None
+     */
+    bool writeJson(const BenchConfig &config, const std::vector<BenchResult> &results)
+    {
+        std::ofstream out(config.json_path.c_str());
+        if (!out)
+        {
+            return false;
+        }
+        out << std::fixed << std::setprecision(1);
+        out << "{\n  \"config\": {\"max_size\": " << config.max_size
+            << ", \"repetitions\": " << config.repetitions
+            << ", \"iterator_checks\": " << MYCONTAINER_ITERATOR_CHECKS << "},\n";
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchResult &r = results[i];
+            out << "    {\"type\": \"" << r.type << "\", \"size\": " << r.size
+                << ", \"operation\": \"" << r.operation << "\", \"median_ns\": " << r.median_ns
+                << ", \"p99_ns\": " << r.p99_ns << ", \"samples\": " << r.samples << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+    /**
+     * @brief Prints the command line usage.
+     * @param None
+     * @returns void
+     * @throw None
+     */
+    void printUsage()
+    {
+        std::cout << "Usage: bench_exe [--max-size N] [--reps R] [--json PATH] [--only suite|topk|traversal|format|io|ingest|merge|sharded|scaling|background|async|generator]" << std::endl;
+        std::cout << "       bench_exe --pgo-train   (runs the profile training workload only)" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config;
+    config.max_size = 10000000;
+    config.repetitions = 5;
+    config.json_path = "bench_results.json";
+    config.section = "all";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--max-size") == 0 && has_value)
+        {
+            config.max_size = std::strtoull(argv[++i], NULL, 10);
+        }
+        else if (std::strcmp(argv[i], "--reps") == 0 && has_value)
+        {
+            config.repetitions = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--json") == 0 && has_value)
+        {
+            config.json_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--only") == 0 && has_value)
+        {
+            config.section = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--pgo-train") == 0)
+        {
+            std::cout << "PGO training workload checksum: " << pgo::runTrainingWorkload() << std::endl;
+            return 0;
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    if (config.section == "all" || config.section == "suite")
+    {
+        benchSuite(config, results);
+        if (!writeJson(config, results))
+        {
+            std::cerr << "Could not write " << config.json_path << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << config.json_path << std::endl;
+    }
+#ifdef MYCONTAINER_HISTOGRAMS
+    if (config.section == "all" || config.section == "suite")
+    {
+        std::cout << "== Latency percentiles (suite) ==" << std::endl;
+        std::cout << LatencyHistograms::instance().toText();
+    }
+#endif
+    if (config.section == "all" || config.section == "topk")
+    {
+        benchTopK(std::min<size_t>(config.max_size, 1000000));
+    }
+    if (config.section == "all" || config.section == "traversal")
+    {
+        benchTraversal(config.max_size);
+    }
+    if (config.section == "all" || config.section == "format")
+    {
+        benchFormat(std::min<size_t>(config.max_size, 1000000));
+    }
+    if (config.section == "all" || config.section == "io")
+    {
+        benchPersistence(config.max_size);
+    }
+    if (config.section == "all" || config.section == "ingest")
+    {
+        benchIngest(config.max_size);
+    }
+    if (config.section == "all" || config.section == "merge")
+    {
+        benchMerge(config.max_size, 8);
+    }
+    if (config.section == "all" || config.section == "sharded")
+    {
+        benchSharded(config.max_size, 8);
+    }
+    if (config.section == "all" || config.section == "scaling")
+    {
+        benchScaling(config.max_size, std::max<size_t>(4, std::thread::hardware_concurrency()));
+    }
+    if (config.section == "all" || config.section == "background")
+    {
+        benchBackground(config.max_size, 5);
+    }
+    if (config.section == "all" || config.section == "async")
+    {
+        benchAsync(config.max_size, std::chrono::milliseconds(50));
+    }
+    if (config.section == "all" || config.section == "generator")
+    {
+        benchGenerator(config.max_size, 10);
+    }
+    return 0;
+}
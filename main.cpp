@@ -192,6 +192,26 @@ int main()
         std::cout << "    Caught expected error: " << e.what() << std::endl;
     }
 
+#ifdef MYCONTAINER_STATS
+    // ========================================
+    // SECTION 7: Instrumentation (-DMYCONTAINER_STATS)
+    // ========================================
+    std::cout << "\n\n========== INSTRUMENTATION ==========" << std::endl;
+    std::cout << "\n16. Int container stats:" << std::endl;
+    std::cout << container.stats().toText();
+    std::cout << "    As JSON: " << container.stats().toJson() << std::endl;
+#endif
+
+#ifdef MYCONTAINER_TRACE
+    std::cout << "\n17. Writing the timeline of this demo to MyContainer_trace.json" << std::endl;
+    Tracer::instance().writeChromeTrace("MyContainer_trace.json");
+#endif
+
+#ifdef MYCONTAINER_HISTOGRAMS
+    std::cout << "\n18. Latency percentiles of every operation in this demo:" << std::endl;
+    std::cout << LatencyHistograms::instance().toText();
+#endif
+
     std::cout << "\n=== Demo Complete ===" << std::endl;
 
     return 0;
@@ -0,0 +1,114 @@
+// yarinkash1@gmail.com
+
+#pragma once
+#include <random>
+#include <string>
+#include <vector>
+#include "MyContainer.hpp"
+
+namespace my_cont_ns
+{
+    namespace pgo
+    {
+        /**
+         * @brief Traverses an order to the end, the way typical consumers do.
+         * @param order The iterator object to traverse.
+         * @returns Number of elements visited.
+         * @throw None
+         */
+        template <typename Iterator>
+        size_t drain(Iterator order)
+        {
+            size_t visited = 0;
+            for (auto it = order.begin(); it != order.end(); ++it)
+            {
+                ++visited;
+            }
+            return visited;
+        }
+
+        /**
+         * @brief Exercises the hot paths of one container: add bursts, removes and all iterators.
+         * @param values The values to insert, in insertion order.
+         * @returns Number of elements visited by the iterators (keeps the work observable).
+         * @throw None
+         */
+        template <typename T>
+        size_t exercise(const std::vector<T> &values)
+        {
+            MyContainer<T> container;
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                container.add(values[i]);
+            }
+
+            size_t visited = 0;
+            visited += drain(container.getAscendingOrder());
+            visited += drain(container.getDescendingOrder());
+            visited += drain(container.getSideCrossOrder());
+            visited += drain(container.getReverseOrder());
+            visited += drain(container.getOrder());
+            visited += drain(container.getMiddleOutOrder());
+
+            // Consumers that only read the head of the sorted order
+            auto lazy = container.getLazyAscendingOrder();
+            size_t head = 0;
+            for (auto it = lazy.begin(); it != lazy.end() && head < 10; ++it, ++head)
+            {
+            }
+            visited += head;
+
+            // Removes of present values, plus misses that throw
+            for (size_t i = 0; i < values.size() && i < 16; i += 3)
+            {
+                try
+                {
+                    container.remove(values[i]);
+                }
+                catch (const std::invalid_argument &)
+                {
+                    // Duplicates already removed by an earlier call
+                }
+            }
+            return visited + container.size();
+        }
+
+        /**
+         * @brief Representative workload used to train profile-guided optimization (make pgo).
+         * Mixes small and large containers of int, double, char and std::string
+         * so that the profile covers add/remove and every iterator constructor and traversal.
+         * @param None
+         * @returns A checksum of the work done.
+         * @throw None
+         */
+        inline size_t runTrainingWorkload()
+        {
+            std::mt19937 rng(2025);
+            size_t checksum = 0;
+            const size_t sizes[] = {8, 64, 1000, 20000, 200000};
+            for (size_t size : sizes)
+            {
+                size_t rounds = 400000 / size + 1;
+                for (size_t round = 0; round < rounds; ++round)
+                {
+                    std::vector<int> ints(size);
+                    std::vector<double> doubles(size);
+                    std::vector<char> chars(size);
+                    std::vector<std::string> strings(size / 4 + 1);
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        ints[i] = static_cast<int>(rng() % (size * 2));
+                        doubles[i] = static_cast<double>(rng()) / 3.0;
+                        chars[i] = static_cast<char>('a' + rng() % 26);
+                    }
+                    for (size_t i = 0; i < strings.size(); ++i)
+                    {
+                        strings[i] = std::to_string(rng() % 100000);
+                    }
+                    checksum += exercise(ints) + exercise(doubles) + exercise(chars) + exercise(strings);
+                }
+            }
+            return checksum;
+        }
+    }
+}
@@ -3,6 +3,21 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "MyContainer.hpp"
+#include "MyContainerView.hpp"
+#include "MyContainerMapped.hpp"
+#include "MyContainerShared.hpp"
+#include "MyContainerSharded.hpp"
+#include "MyContainerThreadPool.hpp"
+#include "MyContainerParallel.hpp"
+#include <atomic>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace my_cont_ns;
 
@@ -1111,4 +1126,1753 @@ TEST_CASE("Char container - empty container operations")
     
     // Try to remove from empty char container
     CHECK_THROWS_AS(charContainer.remove('Z'), std::invalid_argument);
-}
\ No newline at end of file
+}
+// == Test cases for lazy sorted iterators ==
+
+TEST_CASE("Lazy AscendingOrder iterator - matches eager order")
+{
+    MyContainer<int> container;
+    int values[] = {7, 15, 6, 1, 2, 6, 9, 1};
+    for (int value : values)
+    {
+        container.add(value);
+    }
+
+    auto eager = container.getAscendingOrder();
+    auto lazy = container.getLazyAscendingOrder();
+    std::vector<int> eager_result;
+    std::vector<int> lazy_result;
+    for (auto it = eager.begin(); it != eager.end(); ++it)
+    {
+        eager_result.push_back(*it);
+    }
+    for (auto it = lazy.begin(); it != lazy.end(); ++it)
+    {
+        lazy_result.push_back(*it);
+    }
+
+    CHECK(lazy_result == eager_result);
+    CHECK(lazy_result == std::vector<int>{1, 1, 2, 6, 6, 7, 9, 15});
+}
+
+TEST_CASE("Lazy DescendingOrder iterator - early break and shared copies")
+{
+    MyContainer<int> container;
+    for (int i = 0; i < 100; ++i)
+    {
+        container.add((i * 37) % 100); // Permutation of 0..99
+    }
+
+    auto lazy = container.getLazyDescendingOrder();
+    auto it = lazy.begin();
+    auto copy = it; // Copies share the produced prefix
+    CHECK(*it == 99);
+    ++it;
+    CHECK(*it == 98);
+    CHECK(*copy == 99);
+    it++;
+    CHECK(*it == 97);
+
+    // Reading only the first elements must not affect the end position
+    auto end_it = lazy.end();
+    size_t count = 0;
+    for (auto walk = lazy.begin(); walk != end_it; ++walk)
+    {
+        ++count;
+    }
+    CHECK(count == 100);
+}
+
+TEST_CASE("Lazy sorted iterators - produced elements stay put while the rest is popped")
+{
+    MyContainer<std::string> container;
+    for (int i = 0; i < 50; ++i)
+    {
+        container.add(std::to_string((i * 17) % 50 + 100));
+    }
+    auto lazy = container.getLazyAscendingOrder();
+    auto it = lazy.begin();
+    const std::string &first = *it;
+    for (int i = 0; i < 10; ++i)
+    {
+        ++it;
+    }
+    CHECK(first == "100"); // Later pops do not move the produced elements
+    CHECK(*it == "110");
+
+    std::vector<std::string> spans;
+    lazy.forEachSpan([&spans](Span<std::string> span)
+                     { spans.insert(spans.end(), span.data, span.data + span.size); },
+                     7);
+    std::vector<std::string> expected = container.getElements();
+    std::sort(expected.begin(), expected.end());
+    CHECK(spans == expected);
+}
+
+TEST_CASE("Lazy sorted iterators - empty container and bounds checking")
+{
+    MyContainer<std::string> container;
+    auto lazy_asc = container.getLazyAscendingOrder();
+    CHECK(lazy_asc.begin() == lazy_asc.end());
+    CHECK_THROWS_AS(*lazy_asc.begin(), std::out_of_range);
+
+    container.add("pear");
+    container.add("apple");
+    auto lazy_desc = container.getLazyDescendingOrder();
+    auto it = lazy_desc.begin();
+    CHECK(*it == "pear");
+    ++it;
+    CHECK(*it == "apple");
+    ++it;
+    CHECK(it == lazy_desc.end());
+    CHECK_THROWS_AS(*it, std::out_of_range);
+}
+
+// == Test cases for distinct and grouped iterators ==
+
+TEST_CASE("DistinctAscendingOrder iterator - collapses duplicates")
+{
+    MyContainer<int> container;
+    int values[] = {5, 3, 5, 1, 3, 5, 9};
+    for (int value : values)
+    {
+        container.add(value);
+    }
+
+    auto distinct = container.getDistinctAscending();
+    std::vector<int> result;
+    for (auto it = distinct.begin(); it != distinct.end(); ++it)
+    {
+        result.push_back(*it);
+    }
+    CHECK(result == std::vector<int>{1, 3, 5, 9});
+    CHECK(container.size() == 7); // Original container is unchanged
+
+    auto end_it = distinct.end();
+    CHECK_THROWS_AS(*end_it, std::out_of_range);
+}
+
+TEST_CASE("GroupedAscendingOrder iterator - values with multiplicity")
+{
+    MyContainer<std::string> container;
+    container.add("b");
+    container.add("a");
+    container.add("b");
+    container.add("c");
+    container.add("b");
+
+    auto grouped = container.getGroupedAscending();
+    auto it = grouped.begin();
+    CHECK((*it).value == "a");
+    CHECK((*it).count == 1);
+    ++it;
+    CHECK((*it).value == "b");
+    CHECK((*it).count == 3);
+    it++;
+    CHECK((*it).value == "c");
+    CHECK((*it).count == 1);
+    ++it;
+    CHECK(it == grouped.end());
+
+    MyContainer<int> empty;
+    auto empty_grouped = empty.getGroupedAscending();
+    CHECK(empty_grouped.begin() == empty_grouped.end());
+}
+
+// == Test cases for span-based iteration ==
+
+TEST_CASE("forEachSpan - every order yields its traversal in chunks")
+{
+    MyContainer<int> container;
+    int values[] = {7, 15, 6, 1, 2, 9, 4};
+    for (int value : values)
+    {
+        container.add(value);
+    }
+
+    std::vector<int> result;
+    std::vector<size_t> lengths;
+    auto collect = [&](Span<int> span)
+    {
+        lengths.push_back(span.size);
+        result.insert(result.end(), span.data, span.data + span.size);
+    };
+
+    container.getAscendingOrder().forEachSpan(collect, 3);
+    CHECK(result == std::vector<int>{1, 2, 4, 6, 7, 9, 15});
+    CHECK(lengths == std::vector<size_t>{3, 3, 1});
+
+    result.clear();
+    container.getLazyDescendingOrder().forEachSpan(collect, 2);
+    CHECK(result == std::vector<int>{15, 9, 7, 6, 4, 2, 1});
+
+    result.clear();
+    container.getSideCrossOrder().forEachSpan(collect);
+    CHECK(result == std::vector<int>{1, 15, 2, 9, 4, 7, 6});
+
+    result.clear();
+    container.getReverseOrder().forEachSpan(collect, 4);
+    CHECK(result == std::vector<int>{4, 9, 2, 1, 6, 15, 7});
+
+    result.clear();
+    container.getOrder().forEachSpan(collect, 100);
+    CHECK(result == std::vector<int>{7, 15, 6, 1, 2, 9, 4});
+
+    result.clear();
+    container.getMiddleOutOrder().forEachSpan(collect, 5);
+    CHECK(result == std::vector<int>{1, 6, 2, 15, 9, 7, 4});
+}
+
+TEST_CASE("forEachSpan - empty container and invalid chunk size")
+{
+    MyContainer<double> container;
+    size_t calls = 0;
+    auto count_calls = [&](Span<double>) { ++calls; };
+    container.getOrder().forEachSpan(count_calls);
+    container.getLazyAscendingOrder().forEachSpan(count_calls);
+    CHECK(calls == 0);
+
+    container.add(1.5);
+    CHECK_THROWS_AS(container.getOrder().forEachSpan(count_calls, 0), std::invalid_argument);
+    CHECK_THROWS_AS(container.getAscendingOrder().forEachSpan(count_calls, 0), std::invalid_argument);
+}
+
+// == Test cases for materialize / copyOrderTo ==
+
+TEST_CASE("materialize - all six orders match the iterators")
+{
+    MyContainer<int> container;
+    int values[] = {7, 15, 6, 1, 2, 6};
+    for (int value : values)
+    {
+        container.add(value);
+    }
+
+    int buffer[6];
+    container.materialize(OrderKind::AscendingOrder, buffer);
+    CHECK(std::vector<int>(buffer, buffer + 6) == std::vector<int>{1, 2, 6, 6, 7, 15});
+    container.materialize(OrderKind::DescendingOrder, buffer);
+    CHECK(std::vector<int>(buffer, buffer + 6) == std::vector<int>{15, 7, 6, 6, 2, 1});
+    container.materialize(OrderKind::SideCrossOrder, buffer);
+    CHECK(std::vector<int>(buffer, buffer + 6) == std::vector<int>{1, 15, 2, 7, 6, 6});
+    container.materialize(OrderKind::ReverseOrder, buffer);
+    CHECK(std::vector<int>(buffer, buffer + 6) == std::vector<int>{6, 2, 1, 6, 15, 7});
+    container.materialize(OrderKind::Order, buffer);
+    CHECK(std::vector<int>(buffer, buffer + 6) == std::vector<int>{7, 15, 6, 1, 2, 6});
+    container.materialize(OrderKind::MiddleOutOrder, buffer);
+    CHECK(std::vector<int>(buffer, buffer + 6) == std::vector<int>{6, 15, 1, 7, 2, 6});
+}
+
+TEST_CASE("copyOrderTo - middle-out matches the iterator for many sizes")
+{
+    for (int size = 0; size < 12; ++size)
+    {
+        MyContainer<std::string> container;
+        for (int i = 0; i < size; ++i)
+        {
+            container.add(std::string(1, static_cast<char>('a' + i)));
+        }
+
+        std::vector<std::string> expected;
+        auto middle_out = container.getMiddleOutOrder();
+        for (auto it = middle_out.begin(); it != middle_out.end(); ++it)
+        {
+            expected.push_back(*it);
+        }
+
+        std::vector<std::string> result(3, "stale"); // Previous contents are replaced
+        container.copyOrderTo(OrderKind::MiddleOutOrder, result);
+        CHECK(result == expected);
+    }
+}
+
+// == Test cases for buffered formatting (writeTo / writeOrder / print separator) ==
+
+/**
+ * @brief Streams the values one by one, the reference output the formatting engine must reproduce.
+ */
+template <typename T>
+std::string streamOneByOne(const std::vector<T> &values, const std::string &separator)
+{
+    std::ostringstream reference;
+    for (const auto &value : values)
+    {
+        reference << value << separator;
+    }
+    return reference.str();
+}
+
+TEST_CASE("writeTo - integers match one-by-one streaming, including the extremes")
+{
+    std::vector<long long> values = {0, 7, -7, 9, 10, 99, 100, -100, 123456789, std::numeric_limits<long long>::max(),
+                                     std::numeric_limits<long long>::min()};
+    MyContainer<long long> container;
+    for (long long value : values)
+    {
+        container.add(value);
+    }
+    std::ostringstream stream;
+    stream << container;
+    CHECK(stream.str() == streamOneByOne(values, " "));
+
+    MyContainer<unsigned long long> unsigned_container;
+    unsigned_container.add(std::numeric_limits<unsigned long long>::max());
+    unsigned_container.add(0);
+    std::ostringstream unsigned_stream;
+    unsigned_stream << unsigned_container;
+    CHECK(unsigned_stream.str() == "18446744073709551615 0 ");
+
+    MyContainer<int> int_container;
+    int_container.add(std::numeric_limits<int>::min());
+    std::ostringstream int_stream;
+    int_stream << int_container;
+    CHECK(int_stream.str() == "-2147483648 ");
+}
+
+TEST_CASE("writeTo - floating point, char and string match one-by-one streaming")
+{
+    std::vector<double> doubles = {3.14, -0.0, 0.1, 1e20, 1.0 / 3.0, 123456789.0, 2.5e-7, -42.0};
+    MyContainer<double> double_container;
+    for (double value : doubles)
+    {
+        double_container.add(value);
+    }
+    std::ostringstream double_stream;
+    double_stream << double_container;
+    CHECK(double_stream.str() == streamOneByOne(doubles, " "));
+
+    std::ostringstream precise_stream;
+    precise_stream << std::setprecision(15);
+    double_container.writeTo(precise_stream);
+    std::ostringstream precise_expected;
+    precise_expected << std::setprecision(15);
+    for (double value : doubles)
+    {
+        precise_expected << value << " ";
+    }
+    CHECK(precise_stream.str() == precise_expected.str());
+
+    MyContainer<char> char_container;
+    char_container.add('x');
+    char_container.add('7');
+    std::ostringstream char_stream;
+    char_stream << char_container;
+    CHECK(char_stream.str() == "x 7 ");
+
+    MyContainer<std::string> string_container;
+    string_container.add("hello");
+    string_container.add("");
+    string_container.add("world");
+    std::ostringstream string_stream;
+    string_stream << string_container;
+    CHECK(string_stream.str() == "hello  world ");
+}
+
+TEST_CASE("writeTo - non-default stream state keeps the stream's formatting")
+{
+    MyContainer<int> container;
+    container.add(255);
+    container.add(16);
+
+    std::ostringstream hex_stream;
+    hex_stream << std::hex << container;
+    CHECK(hex_stream.str() == "ff 10 ");
+
+    std::ostringstream width_stream;
+    width_stream << std::setw(5) << container;
+    CHECK(width_stream.str() == "  255 16 "); // Width applies to the first element only, as with operator<<
+}
+
+TEST_CASE("writeTo - custom separators and output larger than the internal buffer")
+{
+    MyContainer<int> container;
+    std::vector<int> values;
+    for (int i = 0; i < 50000; ++i)
+    {
+        int value = (i * 7919) % 100003 - 50000;
+        container.add(value);
+        values.push_back(value);
+    }
+    std::ostringstream stream;
+    container.writeTo(stream, ", ");
+    CHECK(stream.str() == streamOneByOne(values, ", "));
+
+    std::ostringstream empty_stream;
+    MyContainer<int> empty;
+    empty.writeTo(empty_stream, ",");
+    CHECK(empty_stream.str() == "");
+
+    std::ostringstream no_separator;
+    MyContainer<int> digits;
+    digits.add(1);
+    digits.add(2);
+    digits.writeTo(no_separator, "");
+    CHECK(no_separator.str() == "12");
+}
+
+TEST_CASE("writeOrder - every order matches its iterator")
+{
+    MyContainer<int> container;
+    int values[] = {7, 15, 6, 1, 2, 6};
+    for (int value : values)
+    {
+        container.add(value);
+    }
+
+    std::ostringstream ascending, descending, side_cross, reverse, order, middle_out;
+    container.writeOrder(ascending, OrderKind::AscendingOrder);
+    container.writeOrder(descending, OrderKind::DescendingOrder);
+    container.writeOrder(side_cross, OrderKind::SideCrossOrder);
+    container.writeOrder(reverse, OrderKind::ReverseOrder);
+    container.writeOrder(order, OrderKind::Order);
+    container.writeOrder(middle_out, OrderKind::MiddleOutOrder, ",");
+    CHECK(ascending.str() == "1 2 6 6 7 15 ");
+    CHECK(descending.str() == "15 7 6 6 2 1 ");
+    CHECK(side_cross.str() == "1 15 2 7 6 6 ");
+    CHECK(reverse.str() == "6 2 1 6 15 7 ");
+    CHECK(order.str() == "7 15 6 1 2 6 ");
+    CHECK(middle_out.str() == "6,15,1,7,2,6,");
+
+    MyContainer<int> empty;
+    std::ostringstream empty_stream;
+    empty.writeOrder(empty_stream, OrderKind::ReverseOrder);
+    CHECK(empty_stream.str() == "");
+}
+
+// == Test cases for save / load ==
+
+TEST_CASE("save and load - round trip of int, double and string containers")
+{
+    const std::string path = "tests_tmp_container.bin";
+
+    MyContainer<int> ints;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ints.add((i * 37) % 211 - 100);
+    }
+    ints.save(path);
+    MyContainer<int> loaded_ints;
+    loaded_ints.add(42); // Replaced by load()
+    loaded_ints.load(path);
+    CHECK(loaded_ints.getElements() == ints.getElements());
+
+    MyContainer<double> doubles;
+    doubles.add(3.5);
+    doubles.add(-0.25);
+    doubles.add(1e300);
+    doubles.save(path);
+    MyContainer<double> loaded_doubles;
+    loaded_doubles.load(path);
+    CHECK(loaded_doubles.getElements() == doubles.getElements());
+
+    MyContainer<std::string> strings;
+    strings.add("alpha");
+    strings.add("");
+    strings.add(std::string("with\0null", 9));
+    strings.add(std::string(5000, 'z'));
+    strings.save(path);
+    MyContainer<std::string> loaded_strings;
+    loaded_strings.load(path);
+    CHECK(loaded_strings.getElements() == strings.getElements());
+
+    MyContainer<int> empty;
+    empty.save(path);
+    loaded_ints.load(path);
+    CHECK(loaded_ints.isEmpty());
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("save and load - loaded container supports every order")
+{
+    const std::string path = "tests_tmp_orders.bin";
+    MyContainer<int> container;
+    int values[] = {7, 15, 6, 1, 2, 6};
+    for (int value : values)
+    {
+        container.add(value);
+    }
+    container.save(path);
+
+    MyContainer<int> loaded;
+    loaded.load(path);
+    std::ostringstream ascending, middle_out;
+    loaded.writeOrder(ascending, OrderKind::AscendingOrder);
+    loaded.writeOrder(middle_out, OrderKind::MiddleOutOrder);
+    CHECK(ascending.str() == "1 2 6 6 7 15 ");
+    CHECK(middle_out.str() == "6 15 1 7 2 6 ");
+    std::remove(path.c_str());
+}
+
+TEST_CASE("load - rejects missing, foreign, mismatched, truncated and corrupted files")
+{
+    const std::string path = "tests_tmp_invalid.bin";
+    MyContainer<int> container;
+    container.add(1);
+    container.add(2);
+    container.add(3);
+
+    MyContainer<int> target;
+    target.add(99);
+    CHECK_THROWS_AS(target.load("tests_tmp_does_not_exist.bin"), std::runtime_error);
+
+    {
+        std::ofstream foreign(path.c_str(), std::ios::binary);
+        foreign << "this is not a container file, but it is long enough for a header";
+    }
+    CHECK_THROWS_AS(target.load(path), std::runtime_error);
+
+    {
+        std::ofstream empty(path.c_str(), std::ios::binary | std::ios::trunc);
+    }
+    CHECK_THROWS_AS(target.load(path), std::runtime_error);
+
+    container.save(path);
+    MyContainer<double> wrong_type;
+    CHECK_THROWS_AS(wrong_type.load(path), std::runtime_error);
+    MyContainer<std::string> wrong_kind;
+    CHECK_THROWS_AS(wrong_kind.load(path), std::runtime_error);
+
+    std::string bytes;
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream truncated(path.c_str(), std::ios::binary | std::ios::trunc);
+        truncated.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 1));
+    }
+    CHECK_THROWS_AS(target.load(path), std::runtime_error);
+
+    {
+        std::string corrupted = bytes;
+        corrupted[corrupted.size() - 1] ^= 0x40; // Flip a payload bit
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+    }
+    CHECK_THROWS_AS(target.load(path), std::runtime_error);
+
+    CHECK(target.getElements() == std::vector<int>{99}); // Failed loads leave the container unchanged
+    std::remove(path.c_str());
+}
+
+// == Test cases for the sort cache and the persisted sorted index ==
+
+TEST_CASE("sort cache - mutations are visible to later iterators, earlier iterators keep their snapshot")
+{
+    MyContainer<int> container;
+    container.add(5);
+    container.add(3);
+    container.add(9);
+
+    auto before = container.getAscendingOrder();
+    std::vector<int> seen;
+    for (auto it = container.getAscendingOrder().begin(); it != container.getAscendingOrder().end(); ++it)
+    {
+        seen.push_back(*it);
+    }
+    CHECK(seen == std::vector<int>{3, 5, 9});
+
+    container.add(1);
+    container.remove(9);
+    std::ostringstream ascending, descending, side_cross, distinct;
+    container.writeOrder(ascending, OrderKind::AscendingOrder);
+    container.writeOrder(descending, OrderKind::DescendingOrder);
+    container.writeOrder(side_cross, OrderKind::SideCrossOrder);
+    for (auto it = container.getDistinctAscending().begin(); it != container.getDistinctAscending().end(); ++it)
+    {
+        distinct << *it << " ";
+    }
+    CHECK(ascending.str() == "1 3 5 ");
+    CHECK(descending.str() == "5 3 1 ");
+    CHECK(side_cross.str() == "1 5 3 ");
+    CHECK(distinct.str() == "1 3 5 ");
+
+    std::vector<int> old_snapshot;
+    for (auto it = before.begin(); it != before.end(); ++it)
+    {
+        old_snapshot.push_back(*it);
+    }
+    CHECK(old_snapshot == std::vector<int>{3, 5, 9});
+}
+
+TEST_CASE("sort cache - copies share the cache but mutate independently")
+{
+    MyContainer<int> original;
+    original.add(2);
+    original.add(1);
+    original.getAscendingOrder(); // Warm the cache before copying
+
+    MyContainer<int> copy = original;
+    copy.add(0);
+    std::ostringstream original_stream, copy_stream;
+    original.writeOrder(original_stream, OrderKind::AscendingOrder);
+    copy.writeOrder(copy_stream, OrderKind::AscendingOrder);
+    CHECK(original_stream.str() == "1 2 ");
+    CHECK(copy_stream.str() == "0 1 2 ");
+}
+
+TEST_CASE("save and load - sorted index round trip serves every sorted order")
+{
+    const std::string path = "tests_tmp_indexed.bin";
+    MyContainer<std::string> container;
+    const char *words[] = {"pear", "apple", "fig", "apple", "kiwi", "fig", "apple"};
+    for (const char *word : words)
+    {
+        container.add(word);
+    }
+    container.save(path, true);
+
+    MyContainer<std::string> loaded;
+    loaded.load(path);
+    CHECK(loaded.getElements() == container.getElements());
+    for (int kind = 0; kind < 6; ++kind)
+    {
+        std::vector<std::string> expected, actual;
+        container.copyOrderTo(static_cast<OrderKind>(kind), expected);
+        loaded.copyOrderTo(static_cast<OrderKind>(kind), actual);
+        CHECK(actual == expected);
+    }
+
+    std::vector<size_t> counts;
+    auto grouped = loaded.getGroupedAscending();
+    for (auto it = grouped.begin(); it != grouped.end(); ++it)
+    {
+        counts.push_back((*it).count);
+    }
+    CHECK(counts == std::vector<size_t>{3, 2, 1, 1});
+
+    MyContainer<int> empty;
+    empty.save(path, true);
+    MyContainer<int> loaded_empty;
+    loaded_empty.add(4);
+    loaded_empty.load(path);
+    CHECK(loaded_empty.isEmpty());
+    CHECK(loaded_empty.getAscendingOrder().begin() == loaded_empty.getAscendingOrder().end());
+    std::remove(path.c_str());
+}
+
+TEST_CASE("load - corrupted sorted index and version 1 files")
+{
+    const std::string path = "tests_tmp_index_errors.bin";
+    MyContainer<int> container;
+    for (int i = 0; i < 64; ++i)
+    {
+        container.add((i * 29) % 64);
+    }
+    container.save(path, true);
+
+    std::string bytes;
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::string corrupted = bytes;
+        corrupted[corrupted.size() - 1] ^= 0x01; // Last run start
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+    }
+    MyContainer<int> target;
+    CHECK_THROWS_AS(target.load(path), std::runtime_error);
+    CHECK(target.isEmpty());
+
+    {
+        std::string version_one = bytes.substr(0, 40 + 64 * sizeof(int)); // Header and payload only
+        version_one[4] = 1;                                                // Version field (host byte order)
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(version_one.data(), static_cast<std::streamsize>(version_one.size()));
+    }
+    target.load(path);
+    CHECK(target.getElements() == container.getElements());
+    std::remove(path.c_str());
+}
+
+// == Test cases for MyContainerView ==
+
+/**
+ * @brief Collects a traversal into a vector.
+ */
+template <typename Iterator>
+std::vector<typename std::decay<decltype(*std::declval<Iterator>())>::type> collect(Iterator order)
+{
+    std::vector<typename std::decay<decltype(*std::declval<Iterator>())>::type> values;
+    for (auto it = order.begin(); it != order.end(); ++it)
+    {
+        values.push_back(*it);
+    }
+    return values;
+}
+
+TEST_CASE("MyContainerView - every order matches MyContainer for many sizes")
+{
+    for (int size = 0; size < 13; ++size)
+    {
+        std::vector<int> data;
+        MyContainer<int> container;
+        for (int i = 0; i < size; ++i)
+        {
+            int value = (i * 7) % 5; // Duplicates included
+            data.push_back(value);
+            container.add(value);
+        }
+        MyContainerView<int> view(data.data(), data.size());
+        CHECK(view.size() == static_cast<size_t>(size));
+        CHECK(collect(view.getAscendingOrder()) == collect(container.getAscendingOrder()));
+        CHECK(collect(view.getDescendingOrder()) == collect(container.getDescendingOrder()));
+        CHECK(collect(view.getSideCrossOrder()) == collect(container.getSideCrossOrder()));
+        CHECK(collect(view.getReverseOrder()) == collect(container.getReverseOrder()));
+        CHECK(collect(view.getOrder()) == collect(container.getOrder()));
+        CHECK(collect(view.getMiddleOutOrder()) == collect(container.getMiddleOutOrder()));
+    }
+}
+
+TEST_CASE("MyContainerView - reads external memory in place")
+{
+    const std::string words[] = {"pear", "apple", "fig", "kiwi"};
+    MyContainerView<std::string> view(words, 4);
+    CHECK(&*view.getOrder().begin() == &words[0]);
+    CHECK(&*view.getAscendingOrder().begin() == &words[1]); // Sorted orders go through the permutation, not a copy
+    CHECK(collect(view.getSideCrossOrder()) == std::vector<std::string>{"apple", "pear", "fig", "kiwi"});
+
+    std::vector<const std::string *> span_starts;
+    view.getOrder().forEachSpan([&span_starts](Span<std::string> span) { span_starts.push_back(span.data); }, 3);
+    CHECK(span_starts == std::vector<const std::string *>{&words[0], &words[3]});
+
+    std::vector<std::string> descending;
+    view.getDescendingOrder().forEachSpan([&descending](Span<std::string> span)
+                                          { descending.insert(descending.end(), span.data, span.data + span.size); }, 3);
+    CHECK(descending == std::vector<std::string>{"pear", "kiwi", "fig", "apple"});
+
+    MyContainerView<int> empty(NULL, 0);
+    CHECK(empty.isEmpty());
+    CHECK(empty.getAscendingOrder().begin() == empty.getAscendingOrder().end());
+    CHECK_THROWS_AS(*empty.getMiddleOutOrder().begin(), std::out_of_range);
+}
+
+// == Test cases for ingest ==
+
+TEST_CASE("ingest - parses a stream the same way as an operator>> loop")
+{
+    // Large enough to cut tokens at the 64 KiB block boundaries
+    std::ostringstream text;
+    std::vector<int> expected;
+    for (int i = 0; i < 30000; ++i)
+    {
+        int value = (i * 7919) % 200003 - 100000;
+        expected.push_back(value);
+        text << value << (i % 3 == 0 ? "\n" : i % 3 == 1 ? " \t " : " ");
+    }
+    text << std::numeric_limits<int>::min() << ' ' << std::numeric_limits<int>::max() << " +5";
+    expected.push_back(std::numeric_limits<int>::min());
+    expected.push_back(std::numeric_limits<int>::max());
+    expected.push_back(5);
+
+    MyContainer<int> container;
+    container.add(1);
+    std::istringstream in(text.str());
+    CHECK(container.ingest(in) == expected.size());
+    expected.insert(expected.begin(), 1);
+    CHECK(container.getElements() == expected);
+
+    MyContainer<double> doubles;
+    std::istringstream double_text("3.5 -0.25\n1e300 7 .5");
+    CHECK(doubles.ingest(double_text) == 5);
+    CHECK(doubles.getElements() == std::vector<double>{3.5, -0.25, 1e300, 7, 0.5});
+
+    MyContainer<std::string> strings;
+    std::istringstream string_text("  pear apple\n\nfig  ");
+    CHECK(strings.ingest(string_text) == 3);
+    CHECK(strings.getElements() == std::vector<std::string>{"pear", "apple", "fig"});
+
+    MyContainer<char> chars;
+    std::istringstream char_text("ab c\nd");
+    CHECK(chars.ingest(char_text) == 4);
+    CHECK(chars.getElements() == std::vector<char>{'a', 'b', 'c', 'd'});
+
+    std::istringstream empty_text(" \n ");
+    CHECK(container.ingest(empty_text) == 0);
+}
+
+TEST_CASE("ingest - invalid tokens throw and leave the container unchanged")
+{
+    MyContainer<int> container;
+    container.add(7);
+    std::istringstream bad("1 2 x 3");
+    CHECK_THROWS_AS(container.ingest(bad), std::invalid_argument);
+    std::istringstream overflow("1 2147483648");
+    CHECK_THROWS_AS(container.ingest(overflow), std::invalid_argument);
+    std::istringstream trailing("1 2abc");
+    CHECK_THROWS_AS(container.ingest(trailing), std::invalid_argument);
+    std::istringstream sign("-");
+    CHECK_THROWS_AS(container.ingest(sign), std::invalid_argument);
+    CHECK(container.getElements() == std::vector<int>{7});
+
+    MyContainer<unsigned> unsigned_container;
+    std::istringstream negative("-1");
+    CHECK_THROWS_AS(unsigned_container.ingest(negative), std::invalid_argument);
+
+    MyContainer<float> floats;
+    std::istringstream huge("1e300");
+    CHECK_THROWS_AS(floats.ingest(huge), std::invalid_argument);
+    for (const char *token : {"nan", "inf", "-infinity", "0x1p3", "1e", ".", "1.5e+"})
+    {
+        std::istringstream special(token);
+        CHECK_THROWS_AS(floats.ingest(special), std::invalid_argument);
+        std::istringstream with_operator(token);
+        float value = 0;
+        const bool whole_token = (with_operator >> value) && with_operator.eof();
+        CHECK_FALSE(whole_token); // operator>> does not accept the whole token either
+    }
+    CHECK(floats.isEmpty());
+    std::istringstream plain("1.5 .5 5. -2e3");
+    floats.ingest(plain);
+    CHECK(floats.getElements() == std::vector<float>{1.5f, 0.5f, 5.0f, -2000.0f});
+
+    CHECK_THROWS_AS(container.ingestFile("tests_tmp_missing.txt"), std::runtime_error);
+}
+
+TEST_CASE("ingestFile - serial and parallel parsing keep the file order")
+{
+    const std::string path = "tests_tmp_ingest.txt";
+    std::vector<long long> expected;
+    {
+        std::ofstream file(path.c_str());
+        for (long long i = 0; i < 50000; ++i)
+        {
+            long long value = (i * 1000003) % 99991 - 50000;
+            expected.push_back(value);
+            file << value << (i % 10 == 9 ? '\n' : ' ');
+        }
+    }
+    for (unsigned threads = 0; threads <= 5; ++threads)
+    {
+        MyContainer<long long> container;
+        CHECK(container.ingestFile(path, threads) == expected.size());
+        CHECK(container.getElements() == expected);
+    }
+
+    MyContainer<long long> sorted;
+    sorted.add(100000);
+    sorted.getAscendingOrder(); // Warm the sort cache, ingest must invalidate it
+    sorted.ingestFile(path, 3);
+    CHECK(*sorted.getDescendingOrder().begin() == 100000);
+    CHECK(*sorted.getAscendingOrder().begin() == *std::min_element(expected.begin(), expected.end()));
+
+    {
+        std::ofstream file(path.c_str(), std::ios::app);
+        file << " oops";
+    }
+    MyContainer<long long> failed;
+    CHECK_THROWS_AS(failed.ingestFile(path, 4), std::invalid_argument);
+    CHECK(failed.isEmpty());
+
+    std::remove(path.c_str());
+}
+
+// == Test cases for the external-memory sort ==
+
+TEST_CASE("external sort - matches the in-memory orders under a small budget")
+{
+    MyContainer<int> container;
+    for (int i = 0; i < 200000; ++i)
+    {
+        container.add(static_cast<int>((i * 2654435761u) % 100003) - 50000);
+    }
+    std::vector<int> ascending(container.size());
+    container.materialize(OrderKind::AscendingOrder, ascending.data());
+
+    const size_t budget = 16 * 1024; // 4096 ints per run, 49 runs, fan-in 3 => several merge passes
+    auto external = container.getExternalAscendingOrder(budget);
+    CHECK(external.spilledRuns() == 49);
+    CHECK(external.mergePasses() > 1);
+    CHECK(external.peakBufferBytes() <= budget);
+    std::vector<int> streamed;
+    for (auto it = external.begin(); it != external.end(); ++it)
+    {
+        streamed.push_back(*it);
+    }
+    CHECK(streamed == ascending);
+
+    std::vector<int> descending;
+    for (int value : container.getExternalDescendingOrder(64 * 1024))
+    {
+        descending.push_back(value);
+    }
+    CHECK(descending == std::vector<int>(ascending.rbegin(), ascending.rend()));
+}
+
+TEST_CASE("external sort - budgets under one block stay within the budget")
+{
+    MyContainer<int> container;
+    for (int i = 0; i < 200000; ++i)
+    {
+        container.add(static_cast<int>((i * 2654435761u) % 100003));
+    }
+    std::vector<int> ascending(container.size());
+    container.materialize(OrderKind::AscendingOrder, ascending.data());
+
+    const size_t budget = 1024; // 256 ints per run, 782 runs, fan-in bounded by the budget
+    auto external = container.getExternalAscendingOrder(budget);
+    CHECK(external.spilledRuns() == 782);
+    CHECK(external.mergePasses() > 1);
+    CHECK(external.peakBufferBytes() <= budget);
+    CHECK(collect(external) == ascending);
+
+    MyContainer<int> small;
+    for (int i = 0; i < 1000; ++i)
+    {
+        small.add((i * 7919) % 1009);
+    }
+    auto minimal = small.getExternalDescendingOrder(3 * sizeof(int)); // 334 runs merged two at a time
+    CHECK(minimal.peakBufferBytes() <= 3 * sizeof(int));
+    CHECK(collect(minimal) == collect(small.getDescendingOrder()));
+}
+
+TEST_CASE("external sort - small containers, budgets and edge cases")
+{
+    MyContainer<double> container;
+    double values[] = {2.5, -1, 7, 2.5, 0};
+    for (double value : values)
+    {
+        container.add(value);
+    }
+    auto fits = container.getExternalAscendingOrder(1024);
+    CHECK(fits.spilledRuns() == 0); // Sorted in memory, nothing spilled
+    CHECK(collect(fits) == std::vector<double>{-1, 0, 2.5, 2.5, 7});
+
+    auto tiny = container.getExternalDescendingOrder(3 * sizeof(double)); // Runs of 3, fan-in 2
+    CHECK(tiny.spilledRuns() == 2);
+    CHECK(collect(tiny) == std::vector<double>{7, 2.5, 2.5, 0, -1});
+    CHECK_THROWS_AS(*tiny, std::out_of_range); // Single pass: the shared position is at the end
+
+    CHECK_THROWS_AS(container.getExternalAscendingOrder(2 * sizeof(double)), std::invalid_argument);
+    CHECK_THROWS_AS(container.getExternalAscendingOrder(3 * sizeof(double), "/nonexistent_dir_for_tests"), std::runtime_error);
+
+    MyContainer<int> empty;
+    auto none = empty.getExternalAscendingOrder(1024);
+    CHECK(none.begin() == none.end());
+}
+
+// == Test cases for MappedContainer ==
+
+TEST_CASE("MappedContainer - grows through the file and matches MyContainer")
+{
+    const std::string path = "tests_tmp_mapped.bin";
+    std::remove(path.c_str());
+    MyContainer<int> reference;
+    {
+        MappedContainer<int> mapped(path);
+        CHECK(mapped.isEmpty());
+        for (int i = 0; i < 50000; ++i) // Several doublings of the file
+        {
+            int value = (i * 7919) % 1009 - 500;
+            mapped.add(value);
+            reference.add(value);
+        }
+        mapped.remove(0);
+        reference.remove(0);
+        CHECK_THROWS_AS(mapped.remove(0), std::invalid_argument);
+        CHECK(mapped.size() == reference.size());
+        CHECK(collect(mapped.getOrder()) == collect(reference.getOrder()));
+        CHECK(collect(mapped.getReverseOrder()) == collect(reference.getReverseOrder()));
+        CHECK(collect(mapped.getMiddleOutOrder()) == collect(reference.getMiddleOutOrder()));
+        CHECK(collect(mapped.getAscendingOrder(16 * 1024)) == collect(reference.getAscendingOrder()));
+        CHECK(collect(mapped.getDescendingOrder()) == collect(reference.getDescendingOrder()));
+        CHECK(collect(mapped.getSideCrossOrder(16 * 1024)) == collect(reference.getSideCrossOrder()));
+        mapped.sync();
+    }
+
+    // The elements persist in the file
+    MappedContainer<int> reopened(path);
+    CHECK(collect(reopened.getOrder()) == collect(reference.getOrder()));
+    reopened.add(12345);
+    CHECK(*reopened.getReverseOrder().begin() == 12345);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("MappedContainer - reopening an emptied file and wrong element types")
+{
+    const std::string path = "tests_tmp_mapped_empty.bin";
+    std::remove(path.c_str());
+    {
+        MappedContainer<double> mapped(path);
+        mapped.add(1.5);
+        mapped.remove(1.5);
+    }
+    {
+        MappedContainer<double> reopened(path); // Trimmed to the header on close, grows again on add()
+        CHECK(reopened.isEmpty());
+        reopened.add(2.5);
+        reopened.add(-1);
+        CHECK(collect(reopened.getAscendingOrder()) == std::vector<double>{-1, 2.5});
+    }
+    CHECK_THROWS_AS(MappedContainer<char>{path}, std::runtime_error);
+    std::remove(path.c_str());
+
+    {
+        std::ofstream garbage(path.c_str());
+        garbage << "not a container";
+    }
+    CHECK_THROWS_AS(MappedContainer<int>{path}, std::runtime_error);
+    std::remove(path.c_str());
+    CHECK_THROWS_AS(MappedContainer<int>("/nonexistent_dir_for_tests/file.bin"), std::runtime_error);
+}
+
+// == Test cases for SharedMyContainer ==
+
+/**
+ * @brief Runs a function in a forked child process and returns its exit status.
+ * The child leaves with _exit() so that it never runs the test framework's shutdown.
+ */
+template <typename Function>
+int runInChild(Function fn)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int status = 1;
+        try
+        {
+            status = fn() ? 0 : 1;
+        }
+        catch (...)
+        {
+        }
+        _exit(status);
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+TEST_CASE("SharedMyContainer - a forked reader sees all six orders of the writer's segment")
+{
+    const std::string name = "/mycontainer_tests_" + std::to_string(getpid());
+    SharedMyContainer<int> writer(name, 100);
+    MyContainer<int> reference;
+    int values[] = {7, 15, 6, 1, 2, 6, 9};
+    for (int value : values)
+    {
+        writer.add(value);
+        reference.add(value);
+    }
+    writer.remove(9);
+    reference.remove(9);
+    CHECK_THROWS_AS(writer.remove(9), std::invalid_argument);
+    CHECK(collect(writer.view().getAscendingOrder()) == collect(reference.getAscendingOrder()));
+
+    int status = runInChild([&]()
+                            {
+                                SharedMyContainer<int> reader(name);
+                                MyContainerView<int> view = reader.view();
+                                bool same = reader.size() == 6 &&
+                                            collect(view.getAscendingOrder()) == collect(reference.getAscendingOrder()) &&
+                                            collect(view.getDescendingOrder()) == collect(reference.getDescendingOrder()) &&
+                                            collect(view.getSideCrossOrder()) == collect(reference.getSideCrossOrder()) &&
+                                            collect(view.getReverseOrder()) == collect(reference.getReverseOrder()) &&
+                                            collect(view.getOrder()) == collect(reference.getOrder()) &&
+                                            collect(view.getMiddleOutOrder()) == collect(reference.getMiddleOutOrder());
+                                try
+                                {
+                                    reader.add(1); // Readers may not write
+                                    return false;
+                                }
+                                catch (const std::runtime_error &)
+                                {
+                                }
+                                return same; });
+    CHECK(status == 0);
+
+    CHECK_THROWS_AS(SharedMyContainer<double>{name}, std::runtime_error);
+    CHECK_THROWS_AS(SharedMyContainer<int>{name + "_missing"}, std::runtime_error);
+    SharedMyContainer<int> full(name + "_full", 2);
+    full.add(1);
+    full.add(2);
+    CHECK_THROWS_AS(full.add(3), std::length_error);
+}
+
+TEST_CASE("SharedMyContainer - read() only returns consistent states while the writer runs")
+{
+    const std::string name = "/mycontainer_tests_seq_" + std::to_string(getpid());
+    const size_t target = 3000;
+    SharedMyContainer<int> writer(name, target);
+    pid_t parent_pid = getpid();
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        bool consistent = true;
+        try
+        {
+            SharedMyContainer<int> reader(name);
+            size_t seen = 0;
+            while (seen < target && consistent)
+            {
+                std::vector<int> ascending;
+                std::vector<int> order;
+                reader.read([&](MyContainerView<int> view)
+                            {
+                                ascending = collect(view.getAscendingOrder());
+                                order = collect(view.getOrder()); });
+                std::sort(order.begin(), order.end());
+                consistent = order == ascending;
+                seen = ascending.size();
+            }
+        }
+        catch (...)
+        {
+            consistent = false;
+        }
+        _exit(consistent && getppid() == parent_pid ? 0 : 1);
+    }
+    for (size_t i = 0; i < target; ++i)
+    {
+        int value = static_cast<int>((i * 7919) % target); // Distinct values, so the size only grows
+        writer.add(value);
+        if (i % 7 == 6)
+        {
+            writer.remove(value); // Also exercise remove() under readers
+            writer.add(value);
+        }
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+    CHECK(writer.version() % 2 == 0);
+}
+
+// == Test cases for the k-way merge ==
+
+TEST_CASE("mergeAscending and mergeDescending - match sorting the concatenation")
+{
+    MyContainer<int> first, second, third, empty, all;
+    for (int i = 0; i < 300; ++i)
+    {
+        int value = (i * 7919) % 101 - 50;
+        (i % 3 == 0 ? first : i % 3 == 1 ? second : third).add(value);
+        all.add(value);
+    }
+    first.add(1000);
+    all.add(1000);
+
+    auto ascending = mergeAscending({&first, &second, &empty, &third});
+    CHECK(ascending.size() == all.size());
+    CHECK(collect(ascending) == collect(all.getAscendingOrder()));
+    CHECK(collect(ascending) == collect(all.getAscendingOrder())); // begin() restarts the merge
+    CHECK(collect(mergeDescending({&third, &empty, &first, &second})) == collect(all.getDescendingOrder()));
+
+    // Single and no containers
+    CHECK(collect(mergeAscending({&second})) == collect(second.getAscendingOrder()));
+    std::vector<const MyContainer<int> *> none;
+    auto nothing = mergeAscending(none);
+    CHECK(nothing.begin() == nothing.end());
+    CHECK_THROWS_AS(*nothing.begin(), std::out_of_range);
+
+    // Snapshot: later changes are not seen
+    auto snapshot = mergeAscending({&first, &second});
+    first.add(-1000);
+    CHECK(*snapshot.begin() != -1000);
+    CHECK(*mergeAscending({&first, &second}).begin() == -1000);
+
+    const MyContainer<int> *null_container = NULL;
+    CHECK_THROWS_AS(mergeAscending({&first, null_container}), std::invalid_argument);
+}
+
+TEST_CASE("mergeAscending - strings and post-increment")
+{
+    MyContainer<std::string> fruits, colors;
+    fruits.add("pear");
+    fruits.add("apple");
+    colors.add("red");
+    colors.add("blue");
+    colors.add("apple");
+    auto merged = mergeAscending({&fruits, &colors});
+    auto it = merged.begin();
+    CHECK(*it++ == "apple");
+    CHECK(*it == "apple");
+    CHECK(collect(merged) == std::vector<std::string>{"apple", "apple", "blue", "pear", "red"});
+}
+
+// == Test cases for ShardedMyContainer ==
+
+TEST_CASE("ShardedMyContainer - behaves like one MyContainer")
+{
+    ShardedMyContainer<int> sharded(4);
+    MyContainer<int> reference;
+    for (int i = 0; i < 500; ++i)
+    {
+        int value = (i * 7919) % 97 - 40;
+        sharded.add(value);
+        reference.add(value);
+    }
+    CHECK(sharded.size() == reference.size());
+    CHECK(sharded.count(5) == reference.count(5));
+    CHECK(sharded.count(1000) == 0);
+
+    sharded.remove(5);
+    reference.remove(5);
+    sharded.remove(-40);
+    reference.remove(-40);
+    CHECK_THROWS_AS(sharded.remove(5), std::invalid_argument);
+    CHECK(sharded.count(5) == 0);
+    CHECK(sharded.size() == reference.size());
+    CHECK(sharded.insertionOrder() == collect(reference.getOrder()));
+    CHECK(collect(sharded.getAscendingOrder()) == collect(reference.getAscendingOrder()));
+    CHECK(collect(sharded.getDescendingOrder()) == collect(reference.getDescendingOrder()));
+
+    // Every value lives in exactly one shard
+    size_t holders = 0;
+    for (size_t s = 0; s < sharded.shardCount(); ++s)
+    {
+        holders += sharded.shard(s).count(7) != 0;
+    }
+    CHECK(holders == 1);
+    CHECK_THROWS_AS(ShardedMyContainer<int>(0), std::invalid_argument);
+}
+
+TEST_CASE("ShardedMyContainer - parallel bulk add keeps insertion order")
+{
+    ShardedMyContainer<std::string> sharded(3);
+    sharded.add("first");
+    std::vector<std::string> batch;
+    for (int i = 0; i < 1000; ++i)
+    {
+        batch.push_back("item" + std::to_string(i % 250));
+    }
+    sharded.addAll(batch);
+    sharded.add("last");
+
+    std::vector<std::string> expected(1, "first");
+    expected.insert(expected.end(), batch.begin(), batch.end());
+    expected.push_back("last");
+    CHECK(sharded.size() == expected.size());
+    CHECK(sharded.insertionOrder() == expected);
+    CHECK(sharded.count("item7") == 4);
+
+    std::sort(expected.begin(), expected.end());
+    CHECK(collect(sharded.getAscendingOrder()) == expected);
+
+    ShardedMyContainer<int> empty(2);
+    CHECK(empty.isEmpty());
+    CHECK(empty.insertionOrder().empty());
+    auto none = empty.getAscendingOrder();
+    CHECK(none.begin() == none.end());
+}
+
+namespace
+{
+    bool copies_fail = false; // While set, copying a CopyBomb of value 13 throws
+
+    struct CopyBomb
+    {
+        int value;
+
+        explicit CopyBomb(int v) : value(v) {}
+
+        CopyBomb(const CopyBomb &other) : value(other.value)
+        {
+            if (copies_fail && value == 13)
+            {
+                throw std::runtime_error("copy failed");
+            }
+        }
+
+        CopyBomb &operator=(const CopyBomb &other)
+        {
+            value = other.value;
+            return *this;
+        }
+
+        bool operator==(const CopyBomb &other) const { return value == other.value; }
+    };
+
+    struct CopyBombHash
+    {
+        size_t operator()(const CopyBomb &bomb) const { return static_cast<size_t>(bomb.value); }
+    };
+
+    std::vector<int> valuesOf(const std::vector<CopyBomb> &bombs)
+    {
+        std::vector<int> values;
+        for (const CopyBomb &bomb : bombs)
+        {
+            values.push_back(bomb.value);
+        }
+        return values;
+    }
+}
+
+TEST_CASE("ShardedMyContainer - a failed add leaves the container unchanged")
+{
+    ShardedMyContainer<CopyBomb, CopyBombHash> sharded(4);
+    for (int i = 0; i < 10; ++i)
+    {
+        sharded.add(CopyBomb(i));
+    }
+    std::vector<CopyBomb> batch;
+    for (int i = 20; i < 60; ++i)
+    {
+        batch.push_back(CopyBomb(i == 40 ? 13 : i));
+    }
+    const std::vector<int> before = valuesOf(sharded.insertionOrder());
+
+    copies_fail = true;
+    CHECK_THROWS_AS(sharded.addAll(batch), std::runtime_error);
+    CHECK_THROWS_AS(sharded.add(CopyBomb(13)), std::runtime_error);
+    copies_fail = false;
+    CHECK(sharded.size() == before.size());
+    CHECK(valuesOf(sharded.insertionOrder()) == before);
+
+    // The sequence numbers stay in step with the shards
+    sharded.add(CopyBomb(100));
+    std::vector<int> expected = before;
+    expected.push_back(100);
+    CHECK(valuesOf(sharded.insertionOrder()) == expected);
+    std::vector<int> reversed(expected.rbegin(), expected.rend());
+    CHECK(valuesOf(collect(sharded.getReverseOrder())) == reversed);
+}
+
+TEST_CASE("ShardedMyContainer - every order matches one MyContainer")
+{
+    for (size_t count : {0u, 1u, 2u, 7u, 300u})
+    {
+        ShardedMyContainer<int> sharded(3);
+        MyContainer<int> reference;
+        for (size_t i = 0; i < count; ++i)
+        {
+            int value = static_cast<int>((i * 37) % 29);
+            sharded.add(value);
+            reference.add(value);
+        }
+        if (count > 100)
+        {
+            sharded.remove(4);
+            reference.remove(4);
+        }
+        CHECK(collect(sharded.getOrder()) == collect(reference.getOrder()));
+        CHECK(collect(sharded.getReverseOrder()) == collect(reference.getReverseOrder()));
+        CHECK(collect(sharded.getMiddleOutOrder()) == collect(reference.getMiddleOutOrder()));
+        CHECK(collect(sharded.getSideCrossOrder()) == collect(reference.getSideCrossOrder()));
+        CHECK(sharded.getMiddleOutOrder().size() == reference.size());
+    }
+
+    ShardedMyContainer<int> one(2);
+    one.add(9);
+    auto middle = one.getMiddleOutOrder();
+    auto it = middle.begin();
+    CHECK(*it == 9);
+    ++it;
+    CHECK(it == middle.end());
+}
+
+// == Test cases for ThreadPool ==
+
+TEST_CASE("ThreadPool - parallelFor covers every index once, nested calls and exceptions")
+{
+    for (size_t workers = 0; workers <= 3; ++workers)
+    {
+        ThreadPool pool(workers);
+        CHECK(pool.workerCount() == workers);
+        std::vector<std::atomic<int>> hits(10007);
+        for (auto &hit : hits)
+        {
+            hit.store(0);
+        }
+        pool.parallelFor(0, hits.size(), 100, [&hits](size_t first, size_t last)
+                         {
+                             for (size_t i = first; i < last; ++i)
+                             {
+                                 hits[i].fetch_add(1);
+                             } });
+        bool all_once = true;
+        for (auto &hit : hits)
+        {
+            all_once = all_once && hit.load() == 1;
+        }
+        CHECK(all_once);
+
+        // Nested fork-join inside tasks must not deadlock
+        std::atomic<size_t> leaves(0);
+        pool.parallelFor(0, 8, 1, [&pool, &leaves](size_t first, size_t last)
+                         {
+                             for (size_t i = first; i < last; ++i)
+                             {
+                                 pool.parallelInvoke([&leaves]() { leaves.fetch_add(1); },
+                                                     [&pool, &leaves]() { pool.parallelFor(0, 4, 1, [&leaves](size_t a, size_t b) { leaves.fetch_add(b - a); }); });
+                             } });
+        CHECK(leaves.load() == 8 * 5);
+
+        CHECK_THROWS_AS(pool.parallelFor(0, 100, 1, [](size_t, size_t last) {
+                            if (last > 50) // Some chunk always covers index 50
+                            {
+                                throw std::runtime_error("chunk failed");
+                            } }),
+                        std::runtime_error);
+        CHECK_THROWS_AS(pool.parallelInvoke([]() {}, []() { throw std::invalid_argument("second failed"); }), std::invalid_argument);
+        pool.parallelFor(5, 5, 1, [](size_t, size_t) { FAIL("empty range must not call fn"); });
+    }
+}
+
+namespace
+{
+    // Chunk function whose copies start failing after a number of copies, like a task that cannot be queued
+    struct FailingCopy
+    {
+        std::atomic<size_t> *calls;
+        std::atomic<int> *copies_left;
+
+        FailingCopy(std::atomic<size_t> *call_count, std::atomic<int> *copy_budget) : calls(call_count), copies_left(copy_budget) {}
+
+        FailingCopy(const FailingCopy &other) : calls(other.calls), copies_left(other.copies_left)
+        {
+            if (copies_left->fetch_sub(1) <= 0)
+            {
+                throw std::bad_alloc();
+            }
+        }
+
+        void operator()(size_t first, size_t last) const { calls->fetch_add(last - first); }
+    };
+}
+
+TEST_CASE("ThreadPool - a chunk that cannot be queued waits for the queued ones")
+{
+    ThreadPool pool(3);
+    for (int budget = 0; budget < 40; ++budget)
+    {
+        std::atomic<size_t> calls(0);
+        std::atomic<int> copies_left(budget);
+        try
+        {
+            pool.parallelFor(0, 1000, 1, FailingCopy(&calls, &copies_left));
+        }
+        catch (const std::bad_alloc &)
+        {
+        }
+        CHECK(calls.load() <= 1000);
+    }
+    // The pool still works afterwards
+    std::atomic<size_t> total(0);
+    pool.parallelFor(0, 1000, 1, [&total](size_t first, size_t last)
+                     { total.fetch_add(last - first); });
+    CHECK(total.load() == 1000);
+}
+
+TEST_CASE("ThreadPool - parallelSort and parallel container operations")
+{
+    std::vector<int> values(200000);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = static_cast<int>((i * 2654435761u) % 100003);
+    }
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+    ThreadPool pool(3);
+    detail::parallelSort(pool, values.begin(), values.end(), std::less<int>());
+    CHECK(values == expected);
+
+    // Large containers sort through the process-wide pool
+    MyContainer<int> container;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        container.add(expected[expected.size() - 1 - i]);
+    }
+    CHECK(collect(container.getAscendingOrder()) == expected);
+}
+
+// == Test cases for parallelForEach and parallelReduce ==
+
+TEST_CASE("parallelForEach - size() and at() match the iterators on all six orders")
+{
+    MyContainer<int> container;
+    for (int value : {7, 15, 6, 1, 2, 9, 4})
+    {
+        container.add(value);
+    }
+    auto ascending = container.getAscendingOrder();
+    auto descending = container.getDescendingOrder();
+    auto side_cross = container.getSideCrossOrder();
+    auto reverse = container.getReverseOrder();
+    auto order = container.getOrder();
+    auto middle_out = container.getMiddleOutOrder();
+    CHECK(ascending.size() == 7);
+    CHECK(ascending.at(0) == 1);
+    CHECK(descending.at(0) == 15);
+    CHECK(side_cross.at(1) == 15);
+    CHECK(reverse.at(0) == 4);
+    CHECK(order.at(6) == 4);
+    CHECK(middle_out.at(0) == 1);
+    CHECK(middle_out.at(6) == 4);
+    CHECK_THROWS_AS(order.at(7), std::out_of_range);
+
+    MyContainer<int> empty;
+    CHECK(empty.getMiddleOutOrder().size() == 0);
+    parallelForEach(empty.getAscendingOrder(), [](const int &) { FAIL("empty order must not call fn"); });
+}
+
+TEST_CASE("parallelForEach / parallelReduce - every element once, results in traversal order")
+{
+    MyContainer<int> container;
+    for (size_t i = 0; i < 5003; ++i)
+    {
+        container.add(static_cast<int>((i * 7919) % 5003)); // 0 .. 5002, each once
+    }
+    for (size_t workers = 0; workers <= 3; ++workers)
+    {
+        ThreadPool pool(workers);
+        std::vector<std::atomic<int>> hits(5003);
+        for (auto &hit : hits)
+        {
+            hit.store(0);
+        }
+        parallelForEach(container.getMiddleOutOrder(), [&hits](const int &value) { hits[value].fetch_add(1); }, 64, pool);
+        bool all_once = true;
+        for (auto &hit : hits)
+        {
+            all_once = all_once && hit.load() == 1;
+        }
+        CHECK(all_once);
+
+        long long sum = parallelReduce(container.getSideCrossOrder(), 0LL,
+                                       [](long long total, const int &value) { return total + value; },
+                                       [](long long a, long long b) { return a + b; }, 100, pool);
+        CHECK(sum == 5002LL * 5003 / 2);
+
+        // A non-commutative combine keeps the traversal order
+        typedef std::vector<int> Sequence;
+        Sequence descending = parallelReduce(container.getDescendingOrder(), Sequence(),
+                                             [](Sequence partial, const int &value) { partial.push_back(value); return partial; },
+                                             [](Sequence a, const Sequence &b) { a.insert(a.end(), b.begin(), b.end()); return a; }, 100, pool);
+        CHECK(descending == collect(container.getDescendingOrder()));
+
+        // A lazy order is completed before the threads read it
+        container.remove(0); // Makes the sort cache stale, so that the order really is lazy
+        container.add(0);
+        Sequence lazy = parallelReduce(container.getLazyAscendingOrder(), Sequence(),
+                                       [](Sequence partial, const int &value) { partial.push_back(value); return partial; },
+                                       [](Sequence a, const Sequence &b) { a.insert(a.end(), b.begin(), b.end()); return a; }, 1, pool);
+        CHECK(lazy == collect(container.getAscendingOrder()));
+
+        CHECK_THROWS_AS(parallelForEach(container.getOrder(), [](const int &value) {
+                            if (value == 4000)
+                            {
+                                throw std::runtime_error("element failed");
+                            } }, 16, pool),
+                        std::runtime_error);
+    }
+}
+
+// == Test cases for background sorting ==
+
+TEST_CASE("Background sort - traversals stay correct while the worker rebuilds the cache")
+{
+    MyContainer<int> container;
+    CHECK_FALSE(container.backgroundSortEnabled());
+    container.enableBackgroundSort(std::chrono::milliseconds(0));
+    CHECK(container.backgroundSortEnabled());
+    std::vector<int> expected;
+    for (int round = 0; round < 50; ++round)
+    {
+        // Mutations race with rebuilds of the previous state, which must never be published
+        for (int i = 0; i < 200; ++i)
+        {
+            int value = (round * 200 + i) * 7919 % 10007;
+            container.add(value);
+            expected.push_back(value);
+        }
+        container.remove(expected[round]);
+        expected.erase(std::remove(expected.begin(), expected.end(), expected[round]), expected.end());
+        std::vector<int> sorted = expected;
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(collect(container.getAscendingOrder()) == sorted);
+    }
+    container.add(-5);
+    container.waitForBackgroundSort();
+    CHECK(*container.getAscendingOrder().begin() == -5);
+
+    // Copies start without the worker; moving from a container turns it off
+    MyContainer<int> copy = container;
+    CHECK_FALSE(copy.backgroundSortEnabled());
+    CHECK(collect(copy.getOrder()) == collect(container.getOrder()));
+    MyContainer<int> moved = std::move(container);
+    CHECK_FALSE(container.backgroundSortEnabled());
+    CHECK(moved.size() == copy.size());
+
+    copy.enableBackgroundSort();
+    copy.disableBackgroundSort();
+    CHECK_FALSE(copy.backgroundSortEnabled());
+    copy.waitForBackgroundSort(); // No worker: returns at once
+}
+
+// == Test cases for asynchronous iterator construction ==
+
+namespace
+{
+    // Ordering that fails on a marked value, to check that build errors reach future.get()
+    struct Fragile
+    {
+        int value;
+        bool operator<(const Fragile &other) const
+        {
+            if (value < 0 || other.value < 0)
+            {
+                throw std::runtime_error("cannot compare");
+            }
+            return value < other.value;
+        }
+        bool operator==(const Fragile &other) const { return value == other.value; }
+    };
+}
+
+TEST_CASE("Async iterators - every order matches its synchronous factory")
+{
+    MyContainer<int> container;
+    for (int i = 0; i < 50000; ++i)
+    {
+        container.add((i * 7919) % 50021);
+    }
+    std::future<MyContainer<int>::AscendingOrder> ascending = container.getAscendingOrderAsync();
+    std::future<MyContainer<int>::DescendingOrder> descending = container.getDescendingOrderAsync();
+    std::future<MyContainer<int>::SideCrossOrder> side_cross = container.getSideCrossOrderAsync();
+    std::future<MyContainer<int>::ReverseOrder> reverse = container.getReverseOrderAsync();
+    std::future<MyContainer<int>::Order> order = container.getOrderAsync();
+    std::future<MyContainer<int>::MiddleOutOrder> middle_out = container.getMiddleOutOrderAsync();
+    CHECK(collect(ascending.get()) == collect(container.getAscendingOrder()));
+    CHECK(collect(descending.get()) == collect(container.getDescendingOrder()));
+    CHECK(collect(side_cross.get()) == collect(container.getSideCrossOrder()));
+    CHECK(collect(reverse.get()) == collect(container.getReverseOrder()));
+    CHECK(collect(order.get()) == collect(container.getOrder()));
+    CHECK(collect(middle_out.get()) == collect(container.getMiddleOutOrder()));
+
+    MyContainer<int> empty;
+    MyContainer<int>::AscendingOrder none = empty.getAscendingOrderAsync().get();
+    CHECK(none.begin() == none.end());
+}
+
+TEST_CASE("Async iterators - a failed build is rethrown by future.get()")
+{
+    MyContainer<Fragile> container;
+    Fragile values[] = {{3}, {-1}, {2}};
+    for (const Fragile &value : values)
+    {
+        container.add(value);
+    }
+    std::future<MyContainer<Fragile>::AscendingOrder> sorted = container.getAscendingOrderAsync();
+    CHECK_THROWS_AS(sorted.get(), std::runtime_error);
+    CHECK(container.getOrderAsync().get().at(1).value == -1); // Needs no comparison
+}
+
+// == Test cases for generate() ==
+
+TEST_CASE("generate - every order matches its iterator, with a cold and a warm sort cache")
+{
+    MyContainer<int> container;
+    for (int i = 0; i < 1001; ++i)
+    {
+        container.add((i * 37) % 250); // Duplicates on purpose
+    }
+    for (int warm = 0; warm < 2; ++warm)
+    {
+        for (int kind = 0; kind < 6; ++kind)
+        {
+            OrderKind order = static_cast<OrderKind>(kind);
+            std::vector<int> expected;
+            switch (order)
+            {
+            case OrderKind::AscendingOrder:
+                expected = collect(container.getAscendingOrder());
+                break;
+            case OrderKind::DescendingOrder:
+                expected = collect(container.getDescendingOrder());
+                break;
+            case OrderKind::SideCrossOrder:
+                expected = collect(container.getSideCrossOrder());
+                break;
+            case OrderKind::ReverseOrder:
+                expected = collect(container.getReverseOrder());
+                break;
+            case OrderKind::Order:
+                expected = collect(container.getOrder());
+                break;
+            case OrderKind::MiddleOutOrder:
+                expected = collect(container.getMiddleOutOrder());
+                break;
+            }
+            if (!warm)
+            {
+                container.add(-1); // Drops the sort cache: the generator starts from heaps and switches midway
+                container.remove(-1);
+            }
+            CHECK(collect(container.generate(order)) == expected);
+        }
+    }
+
+    MyContainer<int> empty;
+    for (int kind = 0; kind < 6; ++kind)
+    {
+        MyContainer<int>::Generator none = empty.generate(static_cast<OrderKind>(kind));
+        CHECK(none.begin() == none.end());
+    }
+}
+
+TEST_CASE("generate - single pass, early stop")
+{
+    MyContainer<int> container;
+    for (int value : {7, 15, 6, 1, 2, 9, 4})
+    {
+        container.add(value);
+    }
+    MyContainer<int>::Generator side_cross = container.generate(OrderKind::SideCrossOrder);
+    std::vector<int> first_three;
+    for (MyContainer<int>::Generator it = side_cross.begin(); it != side_cross.end() && first_three.size() < 3; ++it)
+    {
+        first_three.push_back(*it);
+    }
+    CHECK(first_three == std::vector<int>({1, 15, 2}));
+
+    // Copies share the read position
+    MyContainer<int>::Generator ascending = container.generate(OrderKind::AscendingOrder);
+    MyContainer<int>::Generator copy = ascending;
+    ++ascending;
+    CHECK(*copy == 2);
+    CHECK(*ascending++ == 4); // The returned copy sees the new position too
+    CHECK(*ascending == 4);
+    for (size_t i = 2; i < container.size(); ++i)
+    {
+        ++ascending;
+    }
+    CHECK_THROWS_AS(*ascending, std::out_of_range);
+}
+
+// == Test cases for moved-from containers ==
+
+TEST_CASE("Move - a moved-from container iterates empty in every order")
+{
+    MyContainer<int> source;
+    for (int value : {3, 1, 2, 2})
+    {
+        source.add(value);
+    }
+    source.getAscendingOrder(); // Warms the sort cache
+    source.getGroupedAscending(); // And the run cache
+
+    MyContainer<int> constructed(std::move(source));
+    MyContainer<int> assigned;
+    assigned.add(9);
+    assigned.getAscendingOrder();
+    assigned = std::move(constructed);
+    CHECK(collect(assigned.getAscendingOrder()) == std::vector<int>({1, 2, 2, 3}));
+
+    for (MyContainer<int> *moved : {&source, &constructed})
+    {
+        CHECK(moved->size() == 0);
+        CHECK(collect(moved->getAscendingOrder()).empty());
+        CHECK(collect(moved->getDescendingOrder()).empty());
+        CHECK(collect(moved->getSideCrossOrder()).empty());
+        CHECK(collect(moved->getReverseOrder()).empty());
+        CHECK(collect(moved->getOrder()).empty());
+        CHECK(collect(moved->getMiddleOutOrder()).empty());
+        CHECK(moved->getDistinctAscending().begin() == moved->getDistinctAscending().end());
+    }
+}
@@ -0,0 +1,301 @@
+// yarinkash1@gmail.com
+
+// Tests of the opt-in instrumentation. This file is compiled with the instrumentation
+// flags on (see INSTRUMENT_FLAGS in the makefile), so it is built into its own executable.
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include "MyContainer.hpp"
+#include "MyContainerSharded.hpp"
+
+using namespace my_cont_ns;
+
+// == Test cases for stats() ==
+
+TEST_CASE("stats - counts mutations and misses")
+{
+    MyContainer<int> container;
+    container.add(5);
+    container.add(7);
+    container.add(5);
+    container.remove(5);
+    CHECK_THROWS_AS(container.remove(42), std::invalid_argument);
+
+    const ContainerStats &stats = container.stats();
+    CHECK(stats.adds == 3);
+    CHECK(stats.removes == 1);
+    CHECK(stats.remove_misses == 1);
+}
+
+TEST_CASE("stats - counts iterators, sorts and copied elements")
+{
+    MyContainer<int> container;
+    for (int i = 0; i < 10; ++i)
+    {
+        container.add(i % 4);
+    }
+
+    container.getLazyDescendingOrder(); // Heapified, not sorted
+    container.getAscendingOrder();      // Sorts and fills the sort cache
+    container.getAscendingOrder();      // Served by the sort cache
+    container.getOrder();
+    container.getSideCrossOrder();
+    container.getGroupedAscending();
+
+    const ContainerStats &stats = container.stats();
+    CHECK(stats.iterator_constructions[static_cast<size_t>(OrderKind::AscendingOrder)] == 2);
+    CHECK(stats.iterator_constructions[static_cast<size_t>(OrderKind::DescendingOrder)] == 1);
+    CHECK(stats.iterator_constructions[static_cast<size_t>(OrderKind::Order)] == 1);
+    CHECK(stats.iterator_constructions[static_cast<size_t>(OrderKind::SideCrossOrder)] == 1);
+    CHECK(stats.iterator_constructions[ContainerStats::GROUPED_ASCENDING] == 1);
+    CHECK(stats.iterator_constructions[static_cast<size_t>(OrderKind::MiddleOutOrder)] == 0);
+    CHECK(stats.sorts == 1);
+    CHECK(stats.sort_cache_hits == 3);
+    CHECK(stats.elements_copied == 34); // Heap, sort cache and Order snapshot (10 each), plus 4 groups
+    CHECK(stats.bytes_copied == 34 * sizeof(int));
+}
+
+TEST_CASE("stats - a load with a sorted index warms the sort cache, a mutation invalidates it")
+{
+    const std::string path = "tests_tmp_stats_index.bin";
+    MyContainer<int> source;
+    for (int i = 0; i < 100; ++i)
+    {
+        source.add((i * 37) % 100);
+    }
+    source.save(path, true);
+
+    MyContainer<int> loaded;
+    loaded.load(path);
+    std::remove(path.c_str());
+    loaded.getAscendingOrder();
+    loaded.getDescendingOrder();
+    loaded.getSideCrossOrder();
+    CHECK(loaded.stats().sorts == 0);
+    CHECK(loaded.stats().sort_cache_hits == 3);
+
+    loaded.add(-1);
+    loaded.getAscendingOrder();
+    CHECK(loaded.stats().sorts == 1);
+}
+
+TEST_CASE("stats - warming a sharded container's caches builds no iterators")
+{
+    ShardedMyContainer<int> sharded(3);
+    for (int i = 0; i < 60; ++i)
+    {
+        sharded.add(i);
+    }
+    sharded.prepareSorted();
+    sharded.getAscendingOrder();
+    for (size_t s = 0; s < sharded.shardCount(); ++s)
+    {
+        const ContainerStats &stats = sharded.shard(s).stats();
+        unsigned long long iterators = 0;
+        for (size_t kind = 0; kind < ContainerStats::ITERATOR_KINDS; ++kind)
+        {
+            iterators += stats.iterator_constructions[kind];
+        }
+        CHECK(iterators == 0);
+        CHECK(stats.sorts == (sharded.shard(s).isEmpty() ? 0u : 1u));
+    }
+}
+
+TEST_CASE("stats - background sorting rebuilds the sort cache once per burst of mutations")
+{
+    MyContainer<int> container;
+    container.enableBackgroundSort(std::chrono::milliseconds(20));
+    for (int i = 0; i < 1000; ++i)
+    {
+        container.add((i * 37) % 1000);
+    }
+    container.waitForBackgroundSort();
+    CHECK(container.stats().background_sorts == 1); // The burst was debounced into one rebuild
+    CHECK(container.stats().sorts == 1);
+
+    container.getAscendingOrder(); // Served by the background rebuild
+    container.getDescendingOrder();
+    CHECK(container.stats().sorts == 1);
+    CHECK(container.stats().sort_cache_hits == 2);
+
+    container.disableBackgroundSort();
+    container.add(-1);
+    container.getAscendingOrder();
+    CHECK(container.stats().sorts == 2); // Off again: the reader sorts
+    CHECK(container.stats().background_sorts == 1);
+}
+
+TEST_CASE("stats - reset and dumps")
+{
+    MyContainer<std::string> container;
+    container.add("a");
+    container.getReverseOrder();
+
+    CHECK(container.stats().toText().find("adds:            1") != std::string::npos);
+    std::string json = container.stats().toJson();
+    CHECK(json.find("\"adds\": 1") != std::string::npos);
+    CHECK(json.find("\"ReverseOrder\": 1") != std::string::npos);
+
+    ContainerStats copy = container.stats(); // Copies keep the values
+    container.resetStats();
+    CHECK(container.stats().adds == 0);
+    CHECK(container.stats().iterator_constructions[static_cast<size_t>(OrderKind::ReverseOrder)] == 0);
+    CHECK(copy.adds == 1);
+}
+
+// == Test cases for the Chrome trace export ==
+
+/**
+ * @brief Counts the occurrences of a substring.
+ * @param text The text to search.
+ * @param pattern The substring to count.
+ * @returns Number of non-overlapping occurrences.
+ */
+static size_t countOccurrences(const std::string &text, const std::string &pattern)
+{
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + pattern.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+TEST_CASE("trace - snapshot builds, sorts and removes are recorded as begin/end pairs")
+{
+    Tracer::instance().clear();
+    MyContainer<int> container;
+    for (int i = 0; i < 50; ++i)
+    {
+        container.add(i % 7);
+    }
+    container.getAscendingOrder();
+    container.getMiddleOutOrder();
+    container.remove(3);
+
+    std::vector<TraceEvent> events = Tracer::instance().events();
+    size_t begins = 0;
+    size_t ends = 0;
+    bool saw_ascending = false;
+    bool saw_sort = false;
+    bool saw_remove = false;
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        std::string name = events[i].name;
+        begins += events[i].phase == 'B';
+        ends += events[i].phase == 'E';
+        saw_ascending = saw_ascending || (name == "AscendingOrder" && events[i].count == 50);
+        saw_sort = saw_sort || name == "sort";
+        saw_remove = saw_remove || name == "remove";
+    }
+    CHECK(begins == ends);
+    CHECK(saw_ascending);
+    CHECK(saw_sort);
+    CHECK(saw_remove);
+
+    const std::string path = "trace_test_output.json";
+    Tracer::instance().writeChromeTrace(path);
+    std::ifstream in(path.c_str());
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+    CHECK(text.find("\"traceEvents\"") != std::string::npos);
+    CHECK(countOccurrences(text, "\"ph\": \"B\"") == begins);
+    CHECK(countOccurrences(text, "\"name\": \"MiddleOutOrder\"") == 2);
+}
+
+TEST_CASE("trace - every thread gets its own buffer")
+{
+    Tracer::instance().clear();
+    MyContainer<int> container;
+    container.add(1);
+    std::thread worker([&container]() { container.getOrder(); });
+    worker.join();
+    container.getOrder();
+
+    std::vector<TraceEvent> events = Tracer::instance().events();
+    REQUIRE(events.size() == 4);
+    CHECK(events[0].thread_id != events[2].thread_id);
+}
+
+TEST_CASE("trace - a full ring keeps only the newest events")
+{
+    Tracer::instance().clear();
+    Tracer::instance().setBufferCapacity(4); // Applies to the buffer of the new thread below
+    std::thread worker([]()
+    {
+        MyContainer<int> container;
+        container.add(1);
+        for (int i = 0; i < 10; ++i)
+        {
+            container.getReverseOrder();
+        }
+    });
+    worker.join();
+    Tracer::instance().setBufferCapacity(1 << 16);
+
+    std::vector<TraceEvent> events = Tracer::instance().events();
+    REQUIRE(events.size() == 4);
+    CHECK(events[0].phase == 'B');
+    CHECK(events[3].phase == 'E');
+    CHECK(events[0].nanos <= events[3].nanos);
+}
+
+// == Test cases for the latency histograms ==
+
+TEST_CASE("histogram - percentiles stay within the bucket precision")
+{
+    LatencyHistogram histogram;
+    CHECK(histogram.percentile(99) == 0);
+    for (unsigned long long value = 1; value <= 1000; ++value)
+    {
+        histogram.record(value);
+    }
+    CHECK(histogram.count() == 1000);
+    CHECK(histogram.max() == 1000);
+    CHECK(histogram.mean() == doctest::Approx(500.5));
+
+    // Relative error is below 1 / SUB_BUCKETS
+    unsigned long long p50 = histogram.percentile(50);
+    unsigned long long p99 = histogram.percentile(99);
+    CHECK(p50 >= 500);
+    CHECK(p50 <= 500 + 500 / LatencyHistogram::SUB_BUCKETS);
+    CHECK(p99 >= 990);
+    CHECK(p99 <= 1000);
+    CHECK(histogram.percentile(100) == 1000);
+    CHECK(histogram.percentile(0) == 1);
+
+    histogram.record(5000000000ull); // A 5 second outlier only moves the tail
+    CHECK(histogram.percentile(99) <= 1000);
+    CHECK(histogram.percentile(100) == 5000000000ull);
+
+    histogram.reset();
+    CHECK(histogram.count() == 0);
+}
+
+TEST_CASE("histogram - operations are recorded per type")
+{
+    LatencyHistograms &registry = LatencyHistograms::instance();
+    registry.reset();
+
+    MyContainer<int> container;
+    for (int i = 0; i < 100; ++i)
+    {
+        container.add(i);
+    }
+    container.remove(50);
+    container.getSideCrossOrder();
+    container.getSideCrossOrder();
+
+    CHECK(registry.histogram(LatencyOp::Add).count() == 100);
+    CHECK(registry.histogram(LatencyOp::Remove).count() == 1);
+    CHECK(registry.histogram(LatencyOp::SideCrossOrder).count() == 2);
+    CHECK(registry.histogram(LatencyOp::Order).count() == 0);
+    CHECK(registry.percentile(LatencyOp::SideCrossOrder, 99) > 0);
+    std::string table = registry.toText();
+    CHECK(table.find("SideCrossOrder") != std::string::npos);
+    CHECK(table.find("MiddleOutOrder") == std::string::npos); // Unused operations are skipped
+}